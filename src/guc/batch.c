@@ -0,0 +1,331 @@
+//
+// Copyright 2022 Pablo Delgado Krämer
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "batch.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+static char* copy_string(const char* str, size_t len)
+{
+  char* copy = malloc(len + 1);
+  if (!copy)
+  {
+    return NULL;
+  }
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+static bool path_list_append(struct path_list* list, const char* path, size_t len)
+{
+  if (list->count == list->capacity)
+  {
+    size_t new_capacity = list->capacity ? (list->capacity * 2) : 64;
+    char** new_paths = realloc(list->paths, new_capacity * sizeof(char*));
+    if (!new_paths)
+    {
+      return false;
+    }
+    list->paths = new_paths;
+    list->capacity = new_capacity;
+  }
+
+  char* copy = copy_string(path, len);
+  if (!copy)
+  {
+    return false;
+  }
+
+  list->paths[list->count++] = copy;
+  return true;
+}
+
+void path_list_free(struct path_list* list)
+{
+  for (size_t i = 0; i < list->count; i++)
+  {
+    free(list->paths[i]);
+  }
+  free(list->paths);
+  list->paths = NULL;
+  list->count = 0;
+  list->capacity = 0;
+}
+
+static bool is_path_separator(char c)
+{
+#ifdef _WIN32
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+static const char* find_file_name(const char* path)
+{
+  const char* file_name = path;
+  for (const char* c = path; *c; c++)
+  {
+    if (is_path_separator(*c))
+    {
+      file_name = c + 1;
+    }
+  }
+  return file_name;
+}
+
+static bool has_extension(const char* path, const char* ext)
+{
+  size_t path_len = strlen(path);
+  size_t ext_len = strlen(ext);
+  if (path_len < ext_len)
+  {
+    return false;
+  }
+
+  const char* path_ext = &path[path_len - ext_len];
+  for (size_t i = 0; i < ext_len; i++)
+  {
+    if (tolower((unsigned char) path_ext[i]) != ext[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool is_gltf_file_name(const char* path)
+{
+  return has_extension(path, ".gltf") || has_extension(path, ".glb");
+}
+
+static char* join_path(const char* dir, const char* file_name)
+{
+  size_t dir_len = strlen(dir);
+  size_t file_name_len = strlen(file_name);
+  bool needs_separator = dir_len > 0 && !is_path_separator(dir[dir_len - 1]);
+
+  char* path = malloc(dir_len + needs_separator + file_name_len + 1);
+  if (!path)
+  {
+    return NULL;
+  }
+
+  memcpy(path, dir, dir_len);
+  if (needs_separator)
+  {
+    path[dir_len] = '/';
+  }
+  memcpy(&path[dir_len + needs_separator], file_name, file_name_len + 1);
+  return path;
+}
+
+static int compare_paths(const void* a, const void* b)
+{
+  return strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+static bool read_manifest(const char* path, struct path_list* list)
+{
+  FILE* file = fopen(path, "r");
+  if (!file)
+  {
+    fprintf(stderr, "Unable to open manifest %s.\n", path);
+    return false;
+  }
+
+  bool result = true;
+  char line[4096];
+
+  while (fgets(line, sizeof(line), file))
+  {
+    size_t len = strlen(line);
+    if (len == sizeof(line) - 1 && line[len - 1] != '\n' && !feof(file))
+    {
+      fprintf(stderr, "Line too long in manifest %s.\n", path);
+      result = false;
+      break;
+    }
+
+    // Trim whitespace
+    const char* start = line;
+    while (*start && isspace((unsigned char) *start))
+    {
+      start++;
+    }
+    while (len > 0 && isspace((unsigned char) line[len - 1]))
+    {
+      line[--len] = '\0';
+    }
+
+    if (*start == '\0' || *start == '#')
+    {
+      continue;
+    }
+
+    if (!path_list_append(list, start, strlen(start)))
+    {
+      result = false;
+      break;
+    }
+  }
+
+  fclose(file);
+  return result;
+}
+
+static bool read_directory(const char* path, struct path_list* list)
+{
+  size_t first_index = list->count;
+
+#ifdef _WIN32
+  char* pattern = join_path(path, "*");
+  if (!pattern)
+  {
+    return false;
+  }
+
+  WIN32_FIND_DATAA find_data;
+  HANDLE handle = FindFirstFileA(pattern, &find_data);
+  free(pattern);
+
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    fprintf(stderr, "Unable to open directory %s.\n", path);
+    return false;
+  }
+
+  bool result = true;
+  do
+  {
+    if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || !is_gltf_file_name(find_data.cFileName))
+    {
+      continue;
+    }
+
+    char* file_path = join_path(path, find_data.cFileName);
+    result = file_path && path_list_append(list, file_path, strlen(file_path));
+    free(file_path);
+  }
+  while (result && FindNextFileA(handle, &find_data));
+
+  FindClose(handle);
+#else
+  DIR* dir = opendir(path);
+  if (!dir)
+  {
+    fprintf(stderr, "Unable to open directory %s.\n", path);
+    return false;
+  }
+
+  bool result = true;
+  struct dirent* entry;
+  while (result && (entry = readdir(dir)))
+  {
+    if (!is_gltf_file_name(entry->d_name))
+    {
+      continue;
+    }
+
+    char* file_path = join_path(path, entry->d_name);
+
+    struct stat file_stat;
+    if (file_path && (stat(file_path, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)))
+    {
+      free(file_path);
+      continue;
+    }
+
+    result = file_path && path_list_append(list, file_path, strlen(file_path));
+    free(file_path);
+  }
+
+  closedir(dir);
+#endif
+
+  // Directory iteration order is not defined
+  if (list->count > first_index)
+  {
+    qsort(&list->paths[first_index], list->count - first_index, sizeof(char*), compare_paths);
+  }
+
+  return result;
+}
+
+bool collect_batch_inputs(const char* manifest_or_dir, struct path_list* list)
+{
+  struct stat path_stat;
+  if (stat(manifest_or_dir, &path_stat) != 0)
+  {
+    fprintf(stderr, "Unable to access %s.\n", manifest_or_dir);
+    return false;
+  }
+
+#ifdef _WIN32
+  bool is_dir = (path_stat.st_mode & _S_IFMT) == _S_IFDIR;
+#else
+  bool is_dir = S_ISDIR(path_stat.st_mode);
+#endif
+
+  if (is_dir)
+  {
+    return read_directory(manifest_or_dir, list);
+  }
+
+  return read_manifest(manifest_or_dir, list);
+}
+
+char* make_batch_output_path(const char* out_dir, const char* gltf_path, const char* ext)
+{
+  const char* file_name = find_file_name(gltf_path);
+  const char* file_ext = strrchr(file_name, '.');
+  size_t stem_len = file_ext ? (size_t) (file_ext - file_name) : strlen(file_name);
+
+  if (ext[0] == '.')
+  {
+    ext++;
+  }
+  size_t ext_len = strlen(ext);
+
+  char* out_file_name = malloc(stem_len + 1 + ext_len + 1);
+  if (!out_file_name)
+  {
+    return NULL;
+  }
+
+  memcpy(out_file_name, file_name, stem_len);
+  out_file_name[stem_len] = '.';
+  memcpy(&out_file_name[stem_len + 1], ext, ext_len + 1);
+
+  char* out_path = join_path(out_dir, out_file_name);
+  free(out_file_name);
+  return out_path;
+}
@@ -0,0 +1,36 @@
+//
+// Copyright 2022 Pablo Delgado Krämer
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct path_list
+{
+  char** paths;
+  size_t count;
+  size_t capacity;
+};
+
+void path_list_free(struct path_list* list);
+
+// Collects glTF paths from a manifest file (one path per line, '#' starts a comment)
+// or from the .gltf and .glb files of a directory (non-recursive, sorted by name).
+bool collect_batch_inputs(const char* manifest_or_dir, struct path_list* list);
+
+// Returns <out_dir>/<input file stem>.<ext>. Must be freed by the caller.
+char* make_batch_output_path(const char* out_dir, const char* gltf_path, const char* ext);
@@ -23,6 +23,7 @@
 
 #include <guc.h>
 
+#include "batch.h"
 #include "license.h"
 
 static struct cag_option cmd_options[] = {
@@ -47,6 +48,76 @@ static struct cag_option cmd_options[] = {
     .value_name = "<index>",
     .description = "Index of the material variant that is selected by default"
   },
+  {
+    .identifier = 't',
+    .access_letters = "t",
+    .access_name = "multithreaded",
+    .value_name = NULL,
+    .description = "Process independent conversion steps in parallel"
+  },
+  {
+    .identifier = 'c',
+    .access_letters = "c",
+    .access_name = "image-copy-mode",
+    .value_name = "<mode>",
+    .description = "How to export image files: write, kernel, reflink or hardlink"
+  },
+  {
+    .identifier = 'i',
+    .access_letters = "i",
+    .access_name = "instancing",
+    .value_name = NULL,
+    .description = "Convert meshes, cameras and lights used by multiple nodes to USD instances"
+  },
+  {
+    .identifier = 'o',
+    .access_letters = "o",
+    .access_name = "optimize-meshes",
+    .value_name = NULL,
+    .description = "Weld vertices, remove degenerate triangles and reorder mesh data for rendering"
+  },
+  {
+    .identifier = 'f',
+    .access_letters = "f",
+    .access_name = "face-varying-primvars",
+    .value_name = NULL,
+    .description = "Write generated normals and tangents as indexed faceVarying primvars"
+  },
+  {
+    .identifier = 'p',
+    .access_letters = "p",
+    .access_name = "proxy-ratio",
+    .value_name = "<ratio>",
+    .description = "Create simplified proxy meshes with the given ratio of triangles (0 to 1)"
+  },
+  {
+    .identifier = 'r',
+    .access_letters = "r",
+    .access_name = "primvar-precision",
+    .value_name = "<precision>",
+    .description = "Precision of texture coordinates, colors and tangents: float, auto or half"
+  },
+  {
+    .identifier = 'g',
+    .access_letters = "g",
+    .access_name = "merge-primitives",
+    .value_name = NULL,
+    .description = "Merge compatible mesh primitives into one mesh with per-material GeomSubsets"
+  },
+  {
+    .identifier = 'x',
+    .access_letters = "x",
+    .access_name = "transform-mode",
+    .value_name = "<mode>",
+    .description = "How to convert the node hierarchy: preserve, collapse or flatten transform-only nodes"
+  },
+  {
+    .identifier = 'b',
+    .access_letters = "b",
+    .access_name = "batch",
+    .value_name = "<ext>",
+    .description = "Convert all glTF files of a manifest or directory to the given USD format"
+  },
   {
     .identifier = 'l',
     .access_letters = "l",
@@ -63,12 +134,116 @@ static struct cag_option cmd_options[] = {
   }
 };
 
+static int compare_usd_paths(const void* a, const void* b)
+{
+  return strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+static bool has_duplicate_usd_paths(const struct guc_batch_item* items, size_t item_count)
+{
+  if (item_count < 2)
+  {
+    return false;
+  }
+
+  const char** usd_paths = malloc(item_count * sizeof(const char*));
+  if (!usd_paths)
+  {
+    return true;
+  }
+
+  for (size_t i = 0; i < item_count; i++)
+  {
+    usd_paths[i] = items[i].usd_path;
+  }
+  qsort(usd_paths, item_count, sizeof(const char*), compare_usd_paths);
+
+  bool result = false;
+  for (size_t i = 1; i < item_count && !result; i++)
+  {
+    result = !strcmp(usd_paths[i - 1], usd_paths[i]);
+  }
+
+  free(usd_paths);
+  return result;
+}
+
+static int convert_batch(const char* manifest_or_dir,
+                         const char* out_dir,
+                         const char* ext,
+                         const struct guc_options* options)
+{
+  struct path_list gltf_paths = {0};
+  if (!collect_batch_inputs(manifest_or_dir, &gltf_paths))
+  {
+    path_list_free(&gltf_paths);
+    return EXIT_FAILURE;
+  }
+
+  size_t item_count = gltf_paths.count;
+  struct guc_batch_item* items = calloc(item_count ? item_count : 1, sizeof(struct guc_batch_item));
+  if (!items)
+  {
+    path_list_free(&gltf_paths);
+    return EXIT_FAILURE;
+  }
+
+  bool result = true;
+  for (size_t i = 0; i < item_count && result; i++)
+  {
+    items[i].gltf_path = gltf_paths.paths[i];
+    items[i].usd_path = make_batch_output_path(out_dir, gltf_paths.paths[i], ext);
+    result = (items[i].usd_path != NULL);
+  }
+
+  if (result && has_duplicate_usd_paths(items, item_count))
+  {
+    fprintf(stderr, "Multiple input files map to the same output file.\n");
+    result = false;
+  }
+
+  if (result)
+  {
+    guc_convert_batch(items, item_count, options);
+
+    size_t success_count = 0;
+    for (size_t i = 0; i < item_count; i++)
+    {
+      printf("%s %s -> %s\n", items[i].succeeded ? "OK  " : "FAIL", items[i].gltf_path, items[i].usd_path);
+      success_count += items[i].succeeded;
+    }
+    printf("Converted %zu of %zu assets.\n", success_count, item_count);
+
+    result = (success_count == item_count);
+  }
+
+  for (size_t i = 0; i < item_count; i++)
+  {
+    free((char*) items[i].usd_path);
+  }
+  free(items);
+  path_list_free(&gltf_paths);
+
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char* argv[])
 {
+  const char* batch_ext = NULL;
+
   struct guc_options options = {
     .emit_mtlx = false,
     .mtlx_as_usdshade = false,
-    .default_material_variant = 0
+    .default_material_variant = 0,
+    .multithreaded = false,
+    .image_copy_mode = GUC_IMAGE_COPY_MODE_WRITE,
+    .instancing = false,
+    .optimize_meshes = false,
+    .face_varying_primvars = false,
+    .proxy_ratio = 0.0f,
+    .primvar_precision = GUC_PRIMVAR_PRECISION_FLOAT,
+    .merge_primitives = false,
+    .transform_mode = GUC_TRANSFORM_MODE_PRESERVE
   };
 
   cag_option_context context;
@@ -88,13 +263,116 @@ int main(int argc, char* argv[])
       options.default_material_variant = atoi(value); // fall back to 0 on error
       break;
     }
+    case 't':
+      options.multithreaded = true;
+      break;
+    case 'c': {
+      const char* value = cag_option_get_value(&context);
+      if (!value || !strcmp(value, "write"))
+      {
+        options.image_copy_mode = GUC_IMAGE_COPY_MODE_WRITE;
+      }
+      else if (!strcmp(value, "kernel"))
+      {
+        options.image_copy_mode = GUC_IMAGE_COPY_MODE_KERNEL;
+      }
+      else if (!strcmp(value, "reflink"))
+      {
+        options.image_copy_mode = GUC_IMAGE_COPY_MODE_REFLINK;
+      }
+      else if (!strcmp(value, "hardlink"))
+      {
+        options.image_copy_mode = GUC_IMAGE_COPY_MODE_HARDLINK;
+      }
+      else
+      {
+        fprintf(stderr, "Invalid image copy mode '%s'.\n", value);
+        return EXIT_FAILURE;
+      }
+      break;
+    }
+    case 'i':
+      options.instancing = true;
+      break;
+    case 'o':
+      options.optimize_meshes = true;
+      break;
+    case 'f':
+      options.face_varying_primvars = true;
+      break;
+    case 'p': {
+      const char* value = cag_option_get_value(&context);
+      float ratio = value ? (float) atof(value) : 0.0f;
+      if (ratio <= 0.0f || ratio >= 1.0f)
+      {
+        fprintf(stderr, "Invalid proxy ratio '%s'.\n", value ? value : "");
+        return EXIT_FAILURE;
+      }
+      options.proxy_ratio = ratio;
+      break;
+    }
+    case 'r': {
+      const char* value = cag_option_get_value(&context);
+      if (!value || !strcmp(value, "float"))
+      {
+        options.primvar_precision = GUC_PRIMVAR_PRECISION_FLOAT;
+      }
+      else if (!strcmp(value, "auto"))
+      {
+        options.primvar_precision = GUC_PRIMVAR_PRECISION_AUTO;
+      }
+      else if (!strcmp(value, "half"))
+      {
+        options.primvar_precision = GUC_PRIMVAR_PRECISION_HALF;
+      }
+      else
+      {
+        fprintf(stderr, "Invalid primvar precision '%s'.\n", value);
+        return EXIT_FAILURE;
+      }
+      break;
+    }
+    case 'g':
+      options.merge_primitives = true;
+      break;
+    case 'x': {
+      const char* value = cag_option_get_value(&context);
+      if (!value || !strcmp(value, "preserve"))
+      {
+        options.transform_mode = GUC_TRANSFORM_MODE_PRESERVE;
+      }
+      else if (!strcmp(value, "collapse"))
+      {
+        options.transform_mode = GUC_TRANSFORM_MODE_COLLAPSE;
+      }
+      else if (!strcmp(value, "flatten"))
+      {
+        options.transform_mode = GUC_TRANSFORM_MODE_FLATTEN;
+      }
+      else
+      {
+        fprintf(stderr, "Invalid transform mode '%s'.\n", value);
+        return EXIT_FAILURE;
+      }
+      break;
+    }
+    case 'b': {
+      batch_ext = cag_option_get_value(&context);
+      if (!batch_ext || !strlen(batch_ext))
+      {
+        fprintf(stderr, "Missing batch output format.\n");
+        return EXIT_FAILURE;
+      }
+      break;
+    }
     case 'l': {
       printf("%s\n", license_text);
       return EXIT_SUCCESS;
     }
     case 'h': {
       printf("guc %s - glTF to USD converter\n\n", GUC_VERSION_STRING);
-      printf("Usage: guc [options] [--] <gltf_path> <usd_path>\n\n");
+      printf("Usage: guc [options] [--] <gltf_path> <usd_path>\n");
+      printf("       guc --batch=<ext> [options] [--] <manifest_or_dir> <out_dir>\n\n");
       printf("Options:\n");
       cag_option_print(cmd_options, CAG_ARRAY_SIZE(cmd_options), stdout);
       return EXIT_SUCCESS;
@@ -115,12 +393,12 @@ int main(int argc, char* argv[])
 
   if (param_index >= argc)
   {
-    fprintf(stderr, "Missing positional argument <gltf_path>.\n");
+    fprintf(stderr, "Missing positional argument %s.\n", batch_ext ? "<manifest_or_dir>" : "<gltf_path>");
     return EXIT_FAILURE;
   }
   if ((param_index + 1) >= argc)
   {
-    fprintf(stderr, "Missing positional argument <usd_path>.\n");
+    fprintf(stderr, "Missing positional argument %s.\n", batch_ext ? "<out_dir>" : "<usd_path>");
     return EXIT_FAILURE;
   }
   if ((argc - param_index) != 2)
@@ -129,6 +407,11 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if (batch_ext)
+  {
+    return convert_batch(argv[param_index], argv[param_index + 1], batch_ext, &options);
+  }
+
   const char* gltf_path = argv[param_index];
   const char* usd_path = argv[param_index + 1];
 
@@ -16,12 +16,50 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #else
 #include <stdbool.h>
 #endif
 
+enum guc_image_copy_mode
+{
+  // Write image data from memory.
+  GUC_IMAGE_COPY_MODE_WRITE = 0,
+  // Let the operating system copy image files, e.g. using copy_file_range on Linux.
+  GUC_IMAGE_COPY_MODE_KERNEL,
+  // Clone image files on copy-on-write filesystems (reflink). Falls back to kernel copies.
+  GUC_IMAGE_COPY_MODE_REFLINK,
+  // Like GUC_IMAGE_COPY_MODE_REFLINK, but additionally tries to create hard links before
+  // falling back to kernel copies. Modifying exported images modifies the source images.
+  GUC_IMAGE_COPY_MODE_HARDLINK
+};
+
+enum guc_primvar_precision
+{
+  // Author all primvars with 32-bit floating point precision.
+  GUC_PRIMVAR_PRECISION_FLOAT = 0,
+  // Author texture coordinates, colors and tangents with half precision if they are
+  // stored as normalized integers in the glTF file (KHR_mesh_quantization).
+  GUC_PRIMVAR_PRECISION_AUTO,
+  // Always author texture coordinates, colors and tangents with half precision.
+  GUC_PRIMVAR_PRECISION_HALF
+};
+
+enum guc_transform_mode
+{
+  // Convert each node to an Xform prim with its own transform.
+  GUC_TRANSFORM_MODE_PRESERVE = 0,
+  // Fold chains of nodes that only have a transform and a single child into the
+  // first descendant which has content or several children, using a composed matrix.
+  GUC_TRANSFORM_MODE_COLLAPSE,
+  // Remove all nodes that only have a transform. Their transforms are composed into
+  // the matrices of their descendants, which are moved up the hierarchy.
+  GUC_TRANSFORM_MODE_FLATTEN
+};
+
 struct guc_options
 {
   // Generate and reference a MaterialX document containing an accurate translation
@@ -40,12 +78,70 @@ struct guc_options
   // If the asset supports the KHR_materials_variants extension, select the material
   // variant at the given index by default.
   int default_material_variant;
+
+  // Process independent parts of the conversion, like mesh decoding and tangent
+  // generation, in parallel. The thread count can be limited using USD's
+  // PXR_WORK_THREAD_LIMIT environment variable. Work is split up the same way
+  // with and without this option, so the output is identical to a serial run.
+  bool multithreaded;
+
+  // How existing image files are exported next to the USD file. Embedded images are
+  // always written from memory. Not applicable to USDZ files.
+  enum guc_image_copy_mode image_copy_mode;
+
+  // Convert meshes, cameras and lights that are used by multiple nodes to USD instances.
+  // Their prototypes are placed in the /Asset/Meshes, /Asset/Cameras and /Asset/Lights
+  // scopes, and the prims referencing them are marked as instanceable.
+  bool instancing;
+
+  // Weld identical vertices, remove degenerate triangles, and reorder triangles and
+  // vertices for efficient GPU rendering. Vertex and face order are not preserved.
+  bool optimize_meshes;
+
+  // Keep mesh points indexed when normals or tangents are generated. Generated attributes
+  // are written as indexed faceVarying primvars, so that only values which differ per face
+  // corner are duplicated, instead of de-indexing all vertex data.
+  bool face_varying_primvars;
+
+  // Ratio of triangles to keep in simplified proxy meshes. If greater than zero, a proxy
+  // purpose sibling is created for each triangle mesh and linked from the render purpose mesh.
+  float proxy_ratio;
+
+  // Precision of texture coordinate, color and tangent primvars. Points, normals and
+  // display colors are always authored as floats, as required by the UsdGeom schemas.
+  enum guc_primvar_precision primvar_precision;
+
+  // Merge the primitives of a mesh which have compatible vertex attributes into a single
+  // mesh. The faces of each primitive form a GeomSubset that the material is bound to.
+  bool merge_primitives;
+
+  // How the glTF node hierarchy is converted. Collapsing and flattening reduce the number
+  // of Xform prims in deep hierarchies, like those of CAD assets, while all meshes, cameras
+  // and lights keep their world transforms.
+  enum guc_transform_mode transform_mode;
+};
+
+struct guc_batch_item
+{
+  const char* gltf_path;
+  const char* usd_path;
+
+  // Set by guc_convert_batch to the result of the item's conversion.
+  bool succeeded;
 };
 
 bool guc_convert(const char* gltf_path,
                  const char* usd_path,
                  const struct guc_options* options);
 
+// Converts multiple assets in parallel using a shared worker pool. USD plugins and
+// MaterialX libraries are only initialized once. The USD paths of the items must be
+// distinct. Image file names are prefixed with the stem of the item's USD file, and
+// no two items write the same image file. Returns true if all conversions succeeded.
+bool guc_convert_batch(struct guc_batch_item* items,
+                       size_t item_count,
+                       const struct guc_options* options);
+
 #ifdef __cplusplus
 }
 #endif
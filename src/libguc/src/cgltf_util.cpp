@@ -16,7 +16,11 @@
 
 #include "cgltf_util.h"
 
+#include <pxr/base/arch/defines.h>
+#include <pxr/base/arch/fileSystem.h>
 #include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/work/loops.h>
 #include <pxr/base/gf/math.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/resolver.h>
@@ -28,8 +32,17 @@
 #include <meshoptimizer.h>
 
 #include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <unordered_map>
+#include <vector>
+
+#if defined(ARCH_OS_LINUX) || defined(ARCH_OS_DARWIN)
+#include <sys/mman.h>
+#endif
 
 #include "debugCodes.h"
 
@@ -38,6 +51,8 @@ using namespace PXR_NS;
 namespace detail
 {
   constexpr static const char* GLTF_EXT_MESHOPT_COMPRESSION_EXTENSION_NAME = "EXT_meshopt_compression";
+  constexpr static const char* GLTF_EXT_MESH_GPU_INSTANCING_EXTENSION_NAME = "EXT_mesh_gpu_instancing";
+  constexpr static size_t MESHOPT_POOL_ALIGNMENT = 16;
 
   bool extensionSupported(const char* name)
   {
@@ -55,14 +70,56 @@ namespace detail
            strcmp(name, "KHR_materials_volume") == 0 ||
            strcmp(name, "KHR_mesh_quantization") == 0 ||
            strcmp(name, "KHR_texture_transform") == 0 ||
-           strcmp(name, GLTF_EXT_MESHOPT_COMPRESSION_EXTENSION_NAME) == 0;
+           strcmp(name, GLTF_EXT_MESHOPT_COMPRESSION_EXTENSION_NAME) == 0 ||
+           strcmp(name, GLTF_EXT_MESH_GPU_INSTANCING_EXTENSION_NAME) == 0;
   }
 
   struct BufferHolder
   {
-    std::unordered_map<const char*, std::shared_ptr<const char>> map;
+    struct Entry
+    {
+      std::shared_ptr<const char> buffer;
+      size_t size;
+    };
+    std::unordered_map<const char*, Entry> map;
   };
 
+  // Depending on the resolver, ArAsset::GetBuffer may read the whole file into memory.
+  // For local files, we explicitly map them instead, so that only the pages which are
+  // accessed during conversion are loaded. This includes the binary chunk of GLB files.
+  std::shared_ptr<const char> mapLocalFile(const std::string& path, size_t& size)
+  {
+    if (!TfIsFile(path, /* resolveSymlinks */ true))
+    {
+      return nullptr;
+    }
+
+    FILE* file = ArchOpenFile(path.c_str(), "rb");
+    if (!file)
+    {
+      return nullptr;
+    }
+
+    std::string errMsg;
+    ArchConstFileMapping mapping = ArchMapFileReadOnly(file, &errMsg);
+    fclose(file); // the mapping stays valid
+
+    if (!mapping)
+    {
+      TF_DEBUG(GUC).Msg("unable to map %s: %s\n", path.c_str(), errMsg.c_str());
+      return nullptr;
+    }
+
+    size = ArchGetFileMappingLength(mapping);
+
+#if defined(ARCH_OS_LINUX) || defined(ARCH_OS_DARWIN)
+    // Accessors are mostly read front to back, so we ask for aggressive read-ahead
+    posix_madvise((void*) mapping.get(), size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    return std::shared_ptr<const char>(std::move(mapping));
+  }
+
   cgltf_result readFile(const cgltf_memory_options* memory_options,
                         const cgltf_file_options* file_options,
                         const char* path,
@@ -85,26 +142,38 @@ namespace detail
     std::string resolvedPathStr = resolvedPath.GetPathString();
     TF_DEBUG(GUC).Msg("resolved path to %s\n", resolvedPathStr.c_str());
 
-    std::shared_ptr<ArAsset> asset = resolver.OpenAsset(ArResolvedPath(path));
-    if (!asset)
+    size_t bufferSize = 0;
+    std::shared_ptr<const char> buffer = mapLocalFile(resolvedPathStr, bufferSize);
+
+    if (buffer)
     {
-      TF_RUNTIME_ERROR("unable to open asset %s", resolvedPathStr.c_str());
-      return cgltf_result_file_not_found;
+      TF_DEBUG(GUC).Msg("mapped file %s\n", resolvedPathStr.c_str());
     }
-
-    std::shared_ptr<const char> buffer = asset->GetBuffer();
-    if (!buffer)
+    else
     {
-      TF_RUNTIME_ERROR("unable to open buffer for %s", resolvedPathStr.c_str());
-      return cgltf_result_io_error;
+      std::shared_ptr<ArAsset> asset = resolver.OpenAsset(ArResolvedPath(path));
+      if (!asset)
+      {
+        TF_RUNTIME_ERROR("unable to open asset %s", resolvedPathStr.c_str());
+        return cgltf_result_file_not_found;
+      }
+
+      buffer = asset->GetBuffer();
+      if (!buffer)
+      {
+        TF_RUNTIME_ERROR("unable to open buffer for %s", resolvedPathStr.c_str());
+        return cgltf_result_io_error;
+      }
+
+      bufferSize = asset->GetSize();
     }
 
     const char* bufferPtr = buffer.get();
-    (*size) = asset->GetSize();
+    (*size) = bufferSize;
     (*data) = (void*) bufferPtr;
 
     auto bufferHolder = (BufferHolder*) file_options->user_data;
-    bufferHolder->map[bufferPtr] = buffer;
+    bufferHolder->map[bufferPtr] = { buffer, *size };
 
     return cgltf_result_success;
   }
@@ -118,90 +187,235 @@ namespace detail
     bufferHolder->map.erase(bufferPtr);
   }
 
-  // Based on https://github.com/jkuhlmann/cgltf/pull/129
-  cgltf_result decompressMeshopt(cgltf_data* data)
+  const uint8_t* getAccessorData(const cgltf_accessor* accessor)
   {
-    for (size_t i = 0; i < data->buffer_views_count; ++i)
+    const cgltf_buffer_view* bufferView = accessor->buffer_view;
+    if (!bufferView)
     {
-      cgltf_buffer_view& bufferView = data->buffer_views[i];
+      return nullptr;
+    }
 
-      if (!bufferView.has_meshopt_compression)
+    // Decompressed data (e.g. meshopt) takes precedence over the buffer contents
+    const uint8_t* data = (const uint8_t*) bufferView->data;
+    if (!data)
+    {
+      data = (const uint8_t*) bufferView->buffer->data;
+      if (!data)
       {
-        continue;
+        return nullptr;
       }
+      data += bufferView->offset;
+    }
 
-      const cgltf_meshopt_compression& mc = bufferView.meshopt_compression;
+    return data + accessor->offset;
+  }
 
-      const unsigned char* source = (const unsigned char*) mc.buffer->data;
-      if (!source)
+  // The loops below are kept free of branches and function calls so that they can be
+  // auto-vectorized. Components are read with memcpy because strides are not required
+  // to be a multiple of the component size.
+  template<typename C>
+  void decodeComponents(const uint8_t* src,
+                        size_t srcStride,
+                        size_t elementCount,
+                        size_t componentCount,
+                        float* dst)
+  {
+    if (srcStride == componentCount * sizeof(C))
+    {
+      size_t totalCount = elementCount * componentCount;
+      for (size_t i = 0; i < totalCount; i++)
       {
-        return cgltf_result_invalid_gltf;
+        C value;
+        memcpy(&value, &src[i * sizeof(C)], sizeof(C));
+        dst[i] = float(value);
       }
+      return;
+    }
 
-      source += mc.offset;
-
-      void* result = malloc(mc.count * mc.stride);
-      if (!result)
+    for (size_t i = 0; i < elementCount; i++)
+    {
+      const uint8_t* element = &src[i * srcStride];
+      for (size_t c = 0; c < componentCount; c++)
       {
-        return cgltf_result_out_of_memory;
+        C value;
+        memcpy(&value, &element[c * sizeof(C)], sizeof(C));
+        dst[i * componentCount + c] = float(value);
       }
+    }
+  }
+
+  template<typename C>
+  void decodeNormalizedComponents(const uint8_t* src,
+                                  size_t srcStride,
+                                  size_t elementCount,
+                                  size_t componentCount,
+                                  float divisor,
+                                  float* dst)
+  {
+    decodeComponents<C>(src, srcStride, elementCount, componentCount, dst);
 
-      int errorCode = -1;
+    // Division instead of multiplication with the reciprocal to match cgltf's results
+    size_t totalCount = elementCount * componentCount;
+    for (size_t i = 0; i < totalCount; i++)
+    {
+      dst[i] /= divisor;
+    }
+  }
 
-      switch (mc.mode)
-      {
-      default:
-      case cgltf_meshopt_compression_mode_invalid:
-        break;
+  template<typename C>
+  void decodeIndices(const uint8_t* src, size_t srcStride, size_t count, int* dst)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      C value;
+      memcpy(&value, &src[i * srcStride], sizeof(C));
+      dst[i] = int(value);
+    }
+  }
 
-      case cgltf_meshopt_compression_mode_attributes:
-        errorCode = meshopt_decodeVertexBuffer(result, mc.count, mc.stride, source, mc.size);
-        break;
+  // Based on https://github.com/jkuhlmann/cgltf/pull/129
+  cgltf_result decompressMeshoptBufferView(const cgltf_meshopt_compression& mc, void* result)
+  {
+    const unsigned char* source = (const unsigned char*) mc.buffer->data;
+    if (!source)
+    {
+      return cgltf_result_invalid_gltf;
+    }
 
-      case cgltf_meshopt_compression_mode_triangles:
-        errorCode = meshopt_decodeIndexBuffer(result, mc.count, mc.stride, source, mc.size);
-        break;
+    source += mc.offset;
 
-      case cgltf_meshopt_compression_mode_indices:
-        errorCode = meshopt_decodeIndexSequence(result, mc.count, mc.stride, source, mc.size);
-        break;
-      }
+    int errorCode = -1;
+
+    switch (mc.mode)
+    {
+    default:
+    case cgltf_meshopt_compression_mode_invalid:
+      break;
+
+    case cgltf_meshopt_compression_mode_attributes:
+      errorCode = meshopt_decodeVertexBuffer(result, mc.count, mc.stride, source, mc.size);
+      break;
+
+    case cgltf_meshopt_compression_mode_triangles:
+      errorCode = meshopt_decodeIndexBuffer(result, mc.count, mc.stride, source, mc.size);
+      break;
+
+    case cgltf_meshopt_compression_mode_indices:
+      errorCode = meshopt_decodeIndexSequence(result, mc.count, mc.stride, source, mc.size);
+      break;
+    }
+
+    if (errorCode != 0)
+    {
+      return cgltf_result_io_error;
+    }
+
+    switch (mc.filter)
+    {
+    default:
+    case cgltf_meshopt_compression_filter_none:
+      break;
+
+    case cgltf_meshopt_compression_filter_octahedral:
+      meshopt_decodeFilterOct(result, mc.count, mc.stride);
+      break;
+
+    case cgltf_meshopt_compression_filter_quaternion:
+      meshopt_decodeFilterQuat(result, mc.count, mc.stride);
+      break;
+
+    case cgltf_meshopt_compression_filter_exponential:
+      meshopt_decodeFilterExp(result, mc.count, mc.stride);
+      break;
+    }
+
+    return cgltf_result_success;
+  }
 
-      if (errorCode != 0)
+  // All buffer views are decoded into a single allocation which is owned by the buffer
+  // holder. This way, VtArrays can reference the decoded data just like file buffers.
+  cgltf_result decompressMeshopt(cgltf_data* data, bool multithreaded)
+  {
+    std::vector<cgltf_buffer_view*> bufferViews;
+    std::vector<size_t> offsets;
+    size_t poolSize = 0;
+
+    for (size_t i = 0; i < data->buffer_views_count; ++i)
+    {
+      cgltf_buffer_view* bufferView = &data->buffer_views[i];
+
+      if (!bufferView->has_meshopt_compression)
       {
-        free(result);
-        return cgltf_result_io_error;
+        continue;
       }
 
-      switch (mc.filter)
-      {
-      default:
-      case cgltf_meshopt_compression_filter_none:
-        break;
+      const cgltf_meshopt_compression& mc = bufferView->meshopt_compression;
 
-      case cgltf_meshopt_compression_filter_octahedral:
-        meshopt_decodeFilterOct(result, mc.count, mc.stride);
-        break;
+      bufferViews.push_back(bufferView);
+      offsets.push_back(poolSize);
+      poolSize += (mc.count * mc.stride + MESHOPT_POOL_ALIGNMENT - 1) & ~(MESHOPT_POOL_ALIGNMENT - 1);
+    }
 
-      case cgltf_meshopt_compression_filter_quaternion:
-        meshopt_decodeFilterQuat(result, mc.count, mc.stride);
-        break;
+    if (bufferViews.empty())
+    {
+      return cgltf_result_success;
+    }
+
+    // All buffer views may be empty. Even then, they need a non-null address, and malloc(0)
+    // is allowed to return null.
+    char* pool = (char*) malloc(std::max(poolSize, MESHOPT_POOL_ALIGNMENT));
+    if (!pool)
+    {
+      return cgltf_result_out_of_memory;
+    }
+    std::shared_ptr<const char> poolPtr(pool, free);
+
+    TF_DEBUG(GUC).Msg("decoding %d meshopt buffer views (%zu bytes)\n", int(bufferViews.size()), poolSize);
 
-      case cgltf_meshopt_compression_filter_exponential:
-        meshopt_decodeFilterExp(result, mc.count, mc.stride);
-        break;
+    std::atomic<cgltf_result> result(cgltf_result_success);
+
+    const auto decodeRange = [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+      {
+        cgltf_result viewResult = decompressMeshoptBufferView(bufferViews[i]->meshopt_compression, &pool[offsets[i]]);
+
+        if (viewResult != cgltf_result_success)
+        {
+          result = viewResult;
+        }
       }
+    };
+
+    if (multithreaded)
+    {
+      WorkParallelForN(bufferViews.size(), decodeRange);
+    }
+    else
+    {
+      decodeRange(0, bufferViews.size());
+    }
 
-      bufferView.data = result;
+    if (result != cgltf_result_success)
+    {
+      return result;
     }
 
+    for (size_t i = 0; i < bufferViews.size(); i++)
+    {
+      bufferViews[i]->data = &pool[offsets[i]];
+    }
+
+    auto bufferHolder = (BufferHolder*) data->file.user_data;
+    bufferHolder->map[pool] = { poolPtr, poolSize };
+
     return cgltf_result_success;
   }
 }
 
 namespace guc
 {
-  bool load_gltf(const char* gltfPath, cgltf_data** data)
+  bool load_gltf(const char* gltfPath, cgltf_data** data, bool multithreaded)
   {
     detail::BufferHolder* bufferHolder = new detail::BufferHolder;
 
@@ -262,7 +476,7 @@ namespace guc
       return false;
     }
 
-    result = detail::decompressMeshopt(*data);
+    result = detail::decompressMeshopt(*data, multithreaded);
 
     if (result != cgltf_result_success)
     {
@@ -297,6 +511,17 @@ namespace guc
   void free_gltf(cgltf_data* data)
   {
     auto bufferHolder = (detail::BufferHolder*) data->file.user_data;
+
+    // Decompressed meshopt data is owned by the buffer holder, not by cgltf
+    for (size_t i = 0; i < data->buffer_views_count; i++)
+    {
+      cgltf_buffer_view& bufferView = data->buffer_views[i];
+      if (bufferView.has_meshopt_compression)
+      {
+        bufferView.data = nullptr;
+      }
+    }
+
     cgltf_free(data); // releases buffers in buffer holder
     delete bufferHolder;
   }
@@ -326,6 +551,182 @@ namespace guc
     }
   }
 
+  bool cgltf_accessor_decode_floats(const cgltf_accessor* accessor,
+                                    float* out,
+                                    cgltf_size componentCount)
+  {
+    if (accessor->is_sparse || cgltf_num_components(accessor->type) != componentCount)
+    {
+      return false;
+    }
+    if (accessor->count == 0)
+    {
+      return true;
+    }
+
+    // Like cgltf_accessor_read_float, treat accessors without a buffer view as zero-filled
+    if (!accessor->buffer_view)
+    {
+      memset(out, 0, accessor->count * componentCount * sizeof(float));
+      return true;
+    }
+
+    const uint8_t* src = detail::getAccessorData(accessor);
+    if (!src)
+    {
+      return false;
+    }
+
+    size_t stride = accessor->stride;
+    size_t count = accessor->count;
+    bool normalized = accessor->normalized;
+
+    switch (accessor->component_type)
+    {
+    case cgltf_component_type_r_32f:
+      if (stride == componentCount * sizeof(float))
+      {
+        memcpy(out, src, count * stride);
+      }
+      else
+      {
+        detail::decodeComponents<float>(src, stride, count, componentCount, out);
+      }
+      return true;
+    case cgltf_component_type_r_8:
+      if (normalized)
+      {
+        detail::decodeNormalizedComponents<int8_t>(src, stride, count, componentCount, 127.0f, out);
+      }
+      else
+      {
+        detail::decodeComponents<int8_t>(src, stride, count, componentCount, out);
+      }
+      return true;
+    case cgltf_component_type_r_8u:
+      if (normalized)
+      {
+        detail::decodeNormalizedComponents<uint8_t>(src, stride, count, componentCount, 255.0f, out);
+      }
+      else
+      {
+        detail::decodeComponents<uint8_t>(src, stride, count, componentCount, out);
+      }
+      return true;
+    case cgltf_component_type_r_16:
+      if (normalized)
+      {
+        detail::decodeNormalizedComponents<int16_t>(src, stride, count, componentCount, 32767.0f, out);
+      }
+      else
+      {
+        detail::decodeComponents<int16_t>(src, stride, count, componentCount, out);
+      }
+      return true;
+    case cgltf_component_type_r_16u:
+      if (normalized)
+      {
+        detail::decodeNormalizedComponents<uint16_t>(src, stride, count, componentCount, 65535.0f, out);
+      }
+      else
+      {
+        detail::decodeComponents<uint16_t>(src, stride, count, componentCount, out);
+      }
+      return true;
+    case cgltf_component_type_r_32u:
+      detail::decodeComponents<uint32_t>(src, stride, count, componentCount, out);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  bool cgltf_accessor_decode_ints(const cgltf_accessor* accessor, int* out)
+  {
+    if (accessor->is_sparse || accessor->type != cgltf_type_scalar)
+    {
+      return false;
+    }
+    if (accessor->count == 0)
+    {
+      return true;
+    }
+
+    if (!accessor->buffer_view)
+    {
+      memset(out, 0, accessor->count * sizeof(int));
+      return true;
+    }
+
+    const uint8_t* src = detail::getAccessorData(accessor);
+    if (!src)
+    {
+      return false;
+    }
+
+    size_t stride = accessor->stride;
+    size_t count = accessor->count;
+
+    switch (accessor->component_type)
+    {
+    case cgltf_component_type_r_8u:
+      detail::decodeIndices<uint8_t>(src, stride, count, out);
+      return true;
+    case cgltf_component_type_r_16u:
+      detail::decodeIndices<uint16_t>(src, stride, count, out);
+      return true;
+    case cgltf_component_type_r_32u:
+      if (stride == sizeof(uint32_t))
+      {
+        memcpy(out, src, count * stride);
+      }
+      else
+      {
+        detail::decodeIndices<uint32_t>(src, stride, count, out);
+      }
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  const void* cgltf_accessor_shared_data(const cgltf_data* data,
+                                         const cgltf_accessor* accessor,
+                                         std::shared_ptr<const char>& buffer)
+  {
+    if (accessor->is_sparse || accessor->count == 0)
+    {
+      return nullptr;
+    }
+
+    const char* src = (const char*) detail::getAccessorData(accessor);
+    if (!src)
+    {
+      return nullptr;
+    }
+
+    size_t elementSize = cgltf_calc_size(accessor->type, accessor->component_type);
+    size_t byteLength = (accessor->count - 1) * accessor->stride + elementSize;
+
+    auto bufferHolder = (const detail::BufferHolder*) data->file.user_data;
+
+    // Only a handful of files are loaded per asset, so a linear search is fine. GLB
+    // binary chunks are contained in the file buffer and are found this way, too.
+    for (const auto& entry : bufferHolder->map)
+    {
+      const char* begin = entry.first;
+      const char* end = begin + entry.second.size;
+
+      if (src >= begin && (src + byteLength) <= end)
+      {
+        buffer = entry.second.buffer;
+        return src;
+      }
+    }
+
+    return nullptr;
+  }
+
   const cgltf_accessor* cgltf_find_accessor(const cgltf_primitive* primitive,
                                             const char* name)
   {
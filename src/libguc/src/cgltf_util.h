@@ -18,14 +18,33 @@
 
 #include <cgltf.h>
 
+#include <memory>
+
 namespace guc
 {
-  bool load_gltf(const char* gltfPath, cgltf_data** data);
+  // Buffer views compressed with EXT_meshopt_compression are decoded, in parallel
+  // if multithreaded is set.
+  bool load_gltf(const char* gltfPath, cgltf_data** data, bool multithreaded);
 
   void free_gltf(cgltf_data* data);
 
   const char* cgltf_error_string(cgltf_result result);
 
+  // Decodes all elements of a non-sparse accessor into a tightly packed float array,
+  // converting (normalized) integer components like cgltf_accessor_read_float does.
+  bool cgltf_accessor_decode_floats(const cgltf_accessor* accessor,
+                                    float* out,
+                                    cgltf_size componentCount);
+
+  // Decodes all elements of a non-sparse scalar accessor with unsigned integer components.
+  bool cgltf_accessor_decode_ints(const cgltf_accessor* accessor, int* out);
+
+  // Returns the address of the accessor's first element and the buffer it resides in,
+  // which may outlive the cgltf_data. Returns NULL if the memory is owned by cgltf.
+  const void* cgltf_accessor_shared_data(const cgltf_data* data,
+                                         const cgltf_accessor* accessor,
+                                         std::shared_ptr<const char>& buffer);
+
   const cgltf_accessor* cgltf_find_accessor(const cgltf_primitive* primitive,
                                             const char* name);
 
@@ -18,11 +18,15 @@
 
 #include <pxr/base/tf/envSetting.h>
 #include <pxr/base/gf/matrix4f.h>
+#include <pxr/base/gf/half.h>
+#include <pxr/base/gf/vec2h.h>
+#include <pxr/base/gf/vec3h.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usd/editContext.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/metrics.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
 #include <pxr/usd/usdGeom/scope.h>
 #include <pxr/usd/usdGeom/xform.h>
@@ -34,14 +38,26 @@
 #include <pxr/usd/usdShade/shader.h>
 #include <pxr/usd/usdShade/materialBindingAPI.h>
 #include <pxr/usd/sdf/types.h>
+#include <pxr/usd/sdf/attributeSpec.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/sdf/reference.h>
 #include <pxr/usd/usdMtlx/reader.h>
 #include <pxr/usd/usdMtlx/utils.h>
 #include <pxr/usd/usd/modelAPI.h>
 #include <pxr/usd/kind/registry.h>
+#include <pxr/base/work/dispatcher.h>
 
 #include <MaterialXFormat/XmlIo.h>
 #include <MaterialXFormat/Util.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+
 #include "debugCodes.h"
 #include "usdpreviewsurface.h"
 #include "materialx.h"
@@ -62,6 +78,10 @@ TF_DEFINE_PRIVATE_TOKENS(
   (bitangentSigns)
   (guc)
   (generated)
+  (displayColor)
+  (displayOpacity)
+  (Mesh)
+  (Xform)
 );
 
 const static char* MTLX_GLTF_PBR_FILE_NAME = "gltf_pbr.mtlx";
@@ -77,48 +97,98 @@ namespace detail
 {
   using namespace guc;
 
-  template<typename T>
-  bool readVtArrayFromNonSparseAccessor(const cgltf_accessor* accessor, VtArray<T>& array)
+  // Keeps a glTF buffer alive for as long as VtArrays reference its memory
+  class BufferForeignDataSource : public Vt_ArrayForeignDataSource
   {
-    cgltf_size elementSize = cgltf_calc_size(accessor->type, accessor->component_type);
-
-    array.resize(accessor->count);
+  public:
+    explicit BufferForeignDataSource(std::shared_ptr<const char> buffer)
+      : Vt_ArrayForeignDataSource(&BufferForeignDataSource::detached)
+      , m_buffer(std::move(buffer))
+    {
+    }
 
-    for (size_t i = 0; i < accessor->count; i++)
+  private:
+    static void detached(Vt_ArrayForeignDataSource* self)
     {
-      T& item = array[i];
+      delete static_cast<BufferForeignDataSource*>(self);
+    }
 
-      if constexpr (std::is_same<T, int>())
-      {
-        unsigned int tmpUint = 0;
-        if (!cgltf_accessor_read_uint(accessor, i, &tmpUint, elementSize))
-        {
-          TF_RUNTIME_ERROR("unable to read accessor data");
-          return false;
-        }
-        item = (int) tmpUint;
-      }
-      else if constexpr (std::is_same<T, GfVec2f>() ||
-                         std::is_same<T, GfVec3f>() ||
-                         std::is_same<T, GfVec4f>())
+  private:
+    std::shared_ptr<const char> m_buffer;
+  };
+
+  // If the accessor data can be used as-is, the array aliases the glTF buffer instead of
+  // copying it. VtArray is copy-on-write and detaches from foreign data before mutation.
+  template<typename T>
+  bool createVtArrayFromBuffer(const cgltf_data* data, const cgltf_accessor* accessor, VtArray<T>& array)
+  {
+    if constexpr (std::is_same<T, GfVec2f>() ||
+                  std::is_same<T, GfVec3f>() ||
+                  std::is_same<T, GfVec4f>())
+    {
+      if (accessor->component_type != cgltf_component_type_r_32f ||
+          accessor->normalized ||
+          accessor->stride != sizeof(T) ||
+          cgltf_num_components(accessor->type) != T::dimension)
       {
-        if (!cgltf_accessor_read_float(accessor, i, item.data(), elementSize))
-        {
-          TF_RUNTIME_ERROR("unable to read accessor data");
-          return false;
-        }
+        return false;
       }
-      else
+
+      std::shared_ptr<const char> buffer;
+      const void* src = cgltf_accessor_shared_data(data, accessor, buffer);
+
+      if (!src || (uintptr_t(src) % alignof(T)) != 0)
       {
-        TF_CODING_ERROR("unhandled accessor component type");
         return false;
       }
+
+      auto foreignSource = new BufferForeignDataSource(std::move(buffer));
+      array = VtArray<T>(foreignSource, (T*) src, accessor->count);
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  template<typename T>
+  bool readVtArrayFromNonSparseAccessor(const cgltf_data* data, const cgltf_accessor* accessor, VtArray<T>& array)
+  {
+    if (createVtArrayFromBuffer(data, accessor, array))
+    {
+      return true;
+    }
+
+    array.resize(accessor->count);
+
+    bool result;
+    if constexpr (std::is_same<T, int>())
+    {
+      result = cgltf_accessor_decode_ints(accessor, array.data());
+    }
+    else if constexpr (std::is_same<T, GfVec2f>() ||
+                       std::is_same<T, GfVec3f>() ||
+                       std::is_same<T, GfVec4f>())
+    {
+      result = cgltf_accessor_decode_floats(accessor, (float*) array.data(), T::dimension);
+    }
+    else
+    {
+      TF_CODING_ERROR("unhandled accessor component type");
+      return false;
+    }
+
+    if (!result)
+    {
+      TF_RUNTIME_ERROR("unable to read accessor data");
+      return false;
     }
     return true;
   }
 
   template<typename T>
-  bool readVtArrayFromAccessor(const cgltf_accessor* accessor, VtArray<T>& array)
+  bool readVtArrayFromAccessor(const cgltf_data* data, const cgltf_accessor* accessor, VtArray<T>& array)
   {
     if (accessor->is_sparse)
     {
@@ -159,23 +229,24 @@ namespace detail
         }
       }
     }
-    else if (accessor->buffer_view)
+    else
     {
-      if (!readVtArrayFromNonSparseAccessor(accessor, array))
+      // The glTF spec requires accessors without a buffer view to be initialized with zeros
+      if (!accessor->buffer_view)
+      {
+        TF_DEBUG(GUC).Msg("accessor without buffer view; zero-filling\n");
+      }
+
+      if (!readVtArrayFromNonSparseAccessor(data, accessor, array))
       {
         return false;
       }
     }
-    else
-    {
-      TF_DEBUG(GUC).Msg("empty accessor; defined by unsupported extension?\n");
-      return false;
-    }
     return true;
   }
 
   template<typename T>
-  void deindexVtArray(VtIntArray indices, VtArray<T>& arr)
+  void deindexVtArray(const VtIntArray& indices, VtArray<T>& arr)
   {
     if (arr.empty())
     {
@@ -184,22 +255,167 @@ namespace detail
 
     int newVertexCount = indices.size();
 
+    // Read through const pointers so that arrays referencing glTF buffers are not copied
+    const T* srcData = arr.cdata();
+    const int* indexData = indices.cdata();
+
     VtArray<T> newArr;
     newArr.resize(newVertexCount);
+    T* dstData = newArr.data();
 
     for (int i = 0; i < newVertexCount; i++)
     {
-      newArr[i] = arr[indices[i]];
+      dstData[i] = srcData[indexData[i]];
     }
 
-    arr = newArr;
+    arr = std::move(newArr);
   }
 
-  void markAttributeAsGenerated(UsdAttribute attr)
+  void markAttributeAsGenerated(const SdfAttributeSpecHandle& attr)
   {
     VtDictionary customData;
     customData[_tokens->generated] = true;
-    attr.SetCustomDataByKey(_tokens->guc, VtValue(customData));
+    attr->SetCustomData(_tokens->guc, VtValue(customData));
+  }
+
+  template<typename HalfT, typename T>
+  VtValue makePrimvarValue(const VtArray<T>& values, bool half)
+  {
+    if (!half)
+    {
+      return VtValue(values);
+    }
+
+    VtArray<HalfT> halfValues(values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+      halfValues[i] = HalfT(values[i]);
+    }
+    return VtValue::Take(halfValues);
+  }
+
+  bool hasTriangleTopology(const cgltf_primitive* primitiveData)
+  {
+    return primitiveData->type == cgltf_primitive_type_triangles ||
+           primitiveData->type == cgltf_primitive_type_triangle_strip ||
+           primitiveData->type == cgltf_primitive_type_triangle_fan;
+  }
+
+  // Authors a prim and its attributes directly on the edit target's layer. This is meant to
+  // be used within an SdfChangeBlock, so that the stage processes a single change for the
+  // prim instead of one per attribute. Specs are authored like the UsdGeom schema API would
+  // author them, which means that the caller has to keep the order of the schema API calls.
+  class PrimSpecWriter
+  {
+  public:
+    PrimSpecWriter(const UsdStageRefPtr& stage, const SdfPath& path, const TfToken& typeName)
+    {
+      const UsdEditTarget& editTarget = stage->GetEditTarget();
+      m_spec = SdfCreatePrimInLayer(editTarget.GetLayer(), editTarget.MapToSpecPath(path));
+
+      if (m_spec)
+      {
+        m_spec->SetSpecifier(SdfSpecifierDef);
+        m_spec->SetTypeName(typeName.GetString());
+      }
+    }
+
+    explicit operator bool() const
+    {
+      return bool(m_spec);
+    }
+
+  public:
+    SdfAttributeSpecHandle createAttribute(const TfToken& name,
+                                           const SdfValueTypeName& typeName,
+                                           const VtValue& value,
+                                           SdfVariability variability = SdfVariabilityVarying)
+    {
+      auto attr = SdfAttributeSpec::New(m_spec, name.GetString(), typeName, variability, /* custom */ false);
+      if (attr)
+      {
+        attr->SetDefaultValue(value);
+      }
+      return attr;
+    }
+
+    SdfAttributeSpecHandle createPrimvar(const TfToken& name,
+                                         const SdfValueTypeName& typeName,
+                                         const TfToken& interpolation,
+                                         const VtValue& value,
+                                         const VtIntArray& indices = {})
+    {
+      std::string attrName = "primvars:" + name.GetString();
+
+      auto attr = createAttribute(TfToken(attrName), typeName, value);
+      if (!attr)
+      {
+        return attr;
+      }
+
+      attr->SetInfo(UsdGeomTokens->interpolation, VtValue(interpolation));
+
+      if (!indices.empty())
+      {
+        createAttribute(TfToken(attrName + ":indices"), SdfValueTypeNames->IntArray, VtValue(indices));
+      }
+      return attr;
+    }
+
+    void setMetadata(const TfToken& key, const VtValue& value)
+    {
+      m_spec->SetInfo(key, value);
+    }
+
+  private:
+    SdfPrimSpecHandle m_spec;
+  };
+
+  mx::DocumentPtr loadMtlxStandardLibraries()
+  {
+    mx::FilePathVec libFolders = { "libraries" };
+    mx::FileSearchPath searchPath;
+
+    // Starting from MaterialX 1.38.4 at PR 877, we must remove the "libraries" part:
+    for (const std::string& stdLibPath : UsdMtlxStandardLibraryPaths())
+    {
+      mx::FilePath newPath(stdLibPath);
+      if (newPath.getBaseName() == "libraries") {
+        newPath = newPath.getParentPath();
+      }
+      searchPath.append(newPath);
+
+      auto newPathString = newPath.asString();
+      TF_DEBUG(GUC).Msg("adding UsdMtlx search path %s\n", newPathString.c_str());
+    }
+
+    mx::DocumentPtr libDoc = mx::createDocument();
+    try
+    {
+      mx::loadLibraries(libFolders, searchPath, libDoc);
+    }
+    catch (const mx::Exception& ex)
+    {
+      TF_RUNTIME_ERROR("failed to load MaterialX libraries: %s", ex.what());
+      return nullptr;
+    }
+    return libDoc;
+  }
+
+  // Parsing the libraries takes a significant amount of time, so we only do it once per
+  // process. The document is never modified after loading and can be imported concurrently.
+  // Failed loads are not cached, so that later conversions retry.
+  mx::ConstDocumentPtr getMtlxStandardLibraries()
+  {
+    static std::mutex s_mutex;
+    static mx::ConstDocumentPtr s_libDoc;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_libDoc)
+    {
+      s_libDoc = loadMtlxStandardLibraries();
+    }
+    return s_libDoc;
   }
 }
 
@@ -211,7 +427,8 @@ namespace guc
     , m_params(params)
     , m_mtlxDoc(mx::createDocument())
     , m_mtlxConverter(m_mtlxDoc, m_imgMetadata)
-    , m_usdPreviewSurfaceConverter(m_stage, m_imgMetadata)
+    , m_pathRegistry(m_stage)
+    , m_usdPreviewSurfaceConverter(m_stage, m_imgMetadata, m_pathRegistry)
   {
   }
 
@@ -257,13 +474,15 @@ namespace guc
 
     // Step 2: process images
     processImages(m_data->images, m_data->images_count, m_params.srcDir,
-      m_params.dstDir, m_params.copyExistingFiles, m_params.genRelativePaths, m_imgMetadata);
+      m_params.dstDir, m_params.copyExistingFiles, m_params.genRelativePaths,
+      m_params.imageCopyMode, m_params.keepFilesInMemory, m_params.multithreaded,
+      m_params.imageFileNamePrefix, m_params.sharedImagePaths, m_imgMetadata);
 
     fileExports.reserve(m_imgMetadata.size());
-    for (const auto& imgMetadataPair : m_imgMetadata)
+    for (auto& imgMetadataPair : m_imgMetadata)
     {
-      const ImageMetadata& metadata = imgMetadataPair.second;
-      fileExports.push_back({ metadata.filePath, metadata.refPath });
+      ImageMetadata& metadata = imgMetadataPair.second;
+      fileExports.push_back({ metadata.filePath, metadata.refPath, std::move(metadata.data), metadata.dataSize });
     }
 
     // Step 3: create materials
@@ -289,14 +508,37 @@ namespace guc
       createMaterials(fileExports, createDefaultMaterial);
     }
 
-    // Step 4: create scene graph (nodes, meshes, lights, cameras, ...)
-    auto createNodes = [this](const cgltf_node* nodeData, SdfPath path)
+    // Step 4: decode mesh data up-front so that it can be done concurrently. Stage
+    // authoring is not thread-safe and happens afterwards, in the regular order.
+    countAccessorUses();
+
+    if (m_params.multithreaded)
     {
-      std::string baseName(nodeData->name ? nodeData->name : "node");
-      SdfPath nodePath = makeUniqueStageSubpath(m_stage, path, baseName);
+      decodePrimitives();
+    }
 
-      createNodesRecursively(nodeData, nodePath);
-    };
+    // Step 5: create scene graph (nodes, meshes, lights, cameras, ...)
+    if (m_params.instancing)
+    {
+      if (m_data->scenes_count > 0)
+      {
+        for (size_t i = 0; i < m_data->scenes_count; i++)
+        {
+          const cgltf_scene* sceneData = &m_data->scenes[i];
+          for (size_t j = 0; j < sceneData->nodes_count; j++)
+          {
+            countInstanceUses(sceneData->nodes[j]);
+          }
+        }
+      }
+      else
+      {
+        for (size_t i = 0; i < m_data->nodes_count; i++)
+        {
+          countInstanceUses(&m_data->nodes[i]);
+        }
+      }
+    }
 
     for (size_t i = 0; i < m_data->scenes_count; i++)
     {
@@ -308,7 +550,7 @@ namespace guc
 
       const cgltf_scene* sceneData = &m_data->scenes[i];
       std::string name(sceneData->name ? sceneData->name : "scene");
-      SdfPath scenePath = makeUniqueStageSubpath(m_stage, scenesPath, name);
+      SdfPath scenePath = m_pathRegistry.makeUniqueSubpath(scenesPath, name);
 
       auto xform = UsdGeomXform::Define(m_stage, scenePath);
       if (m_data->scenes_count > 1)
@@ -321,12 +563,14 @@ namespace guc
         }
       }
 
+      std::vector<NodePlan> nodePlans;
       for (size_t i = 0; i < sceneData->nodes_count; i++)
       {
         const cgltf_node* nodeData = sceneData->nodes[i];
 
-        createNodes(nodeData, scenePath);
+        planNodes(nodeData, scenePath, nodePlans);
       }
+      createNodes(nodePlans);
 
       if (sceneData->name)
       {
@@ -365,12 +609,14 @@ namespace guc
       auto scope = UsdGeomScope::Define(m_stage, nodesPath);
       scope.MakeInvisible();
 
+      std::vector<NodePlan> nodePlans;
       for (size_t i = 0; i < m_data->nodes_count; i++)
       {
         const cgltf_node* nodeData = &m_data->nodes[i];
 
-        createNodes(nodeData, nodesPath);
+        planNodes(nodeData, nodesPath, nodePlans);
       }
+      createNodes(nodePlans);
     }
   }
 
@@ -380,33 +626,14 @@ namespace guc
     // because UsdMtlx tries to output them, we only do so when not exporting UsdShade.
     if (m_params.emitMtlx && !m_params.mtlxAsUsdShade)
     {
-      mx::FilePathVec libFolders = { "libraries" };
-      mx::FileSearchPath searchPath;
-
-      // Starting from MaterialX 1.38.4 at PR 877, we must remove the "libraries" part:
-      for (const std::string& stdLibPath : UsdMtlxStandardLibraryPaths())
-      {
-        mx::FilePath newPath(stdLibPath);
-        if (newPath.getBaseName() == "libraries") {
-          newPath = newPath.getParentPath();
-        }
-        searchPath.append(newPath);
-
-        auto newPathString = newPath.asString();
-        TF_DEBUG(GUC).Msg("adding UsdMtlx search path %s\n", newPathString.c_str());
-      }
-
-      try
-      {
-        mx::loadLibraries(libFolders, searchPath, m_mtlxDoc);
-      }
-      catch (const mx::Exception& ex)
+      mx::ConstDocumentPtr libDoc = detail::getMtlxStandardLibraries();
+      if (libDoc)
       {
-        TF_RUNTIME_ERROR("failed to load MaterialX libraries: %s", ex.what());
+        m_mtlxDoc->importLibrary(libDoc);
       }
     }
 
-    std::unordered_set<std::string> materialNameSet;
+    UniqueNameRegistry materialNameRegistry = makeMaterialNameRegistry();
 
     // Create a default material if needed (glTF spec. 3.7.2.1)
     if (createDefaultMaterial)
@@ -420,7 +647,7 @@ namespace guc
       {
         m_mtlxConverter.convert(&DEFAULT_MATERIAL, DEFAULT_MATERIAL_NAME);
       }
-      materialNameSet.insert(DEFAULT_MATERIAL_NAME);
+      materialNameRegistry.reserveName(DEFAULT_MATERIAL_NAME);
     }
 
     m_materialNames.resize(m_data->materials_count);
@@ -433,8 +660,7 @@ namespace guc
       std::string& materialName = m_materialNames[i];
       {
         materialName = gmat->name ? std::string(gmat->name) : "";
-        materialName = makeUniqueMaterialName(materialName, materialNameSet);
-        materialNameSet.insert(materialName);
+        materialName = makeUniqueMaterialName(materialName, materialNameRegistry);
       }
 
       SdfPath previewPath = makeUsdPreviewSurfaceMaterialPath(m_materialNames[i]);
@@ -479,22 +705,239 @@ namespace guc
 
       auto mtlxFileName = m_params.mtlxFileName;
       auto mtlxFilePath = m_params.dstDir / mtlxFileName;
-      TF_DEBUG(GUC).Msg("writing mtlx file %s\n", mtlxFilePath.string().c_str());
-      mx::writeToXmlFile(m_mtlxDoc, mx::FilePath(mtlxFilePath.string()), &writeOptions);
 
-      // And create a reference to it
       auto over = m_stage->OverridePrim(getEntryPath(EntryPathType::MaterialXMaterials));
-      auto references = over.GetReferences();
-      TF_VERIFY(references.AddReference(mtlxFileName.string(), SdfPath("/MaterialX")));
+      SdfPath mtlxRootPath("/MaterialX");
+
+      if (m_params.keepFilesInMemory)
+      {
+        auto xml = std::make_shared<std::string>(mx::writeToXmlString(m_mtlxDoc, &writeOptions));
+
+        FileExport fileExport = { mtlxFilePath.string(), mtlxFileName.string(), std::shared_ptr<const char>(xml, xml->data()), xml->size() };
+        fileExport.referencingPrimPath = over.GetPath();
+        fileExport.referencedPrimPath = mtlxRootPath;
+        fileExports.push_back(fileExport);
+      }
+      else
+      {
+        TF_DEBUG(GUC).Msg("writing mtlx file %s\n", mtlxFilePath.string().c_str());
+        mx::writeToXmlFile(m_mtlxDoc, mx::FilePath(mtlxFilePath.string()), &writeOptions);
+
+        // And create a reference to it
+        auto references = over.GetReferences();
+        TF_VERIFY(references.AddReference(mtlxFileName.string(), mtlxRootPath));
 
-      fileExports.push_back({ mtlxFilePath.string(), mtlxFileName.string() });
+        fileExports.push_back({ mtlxFilePath.string(), mtlxFileName.string() });
+      }
     }
   }
 
-  void Converter::createNodesRecursively(const cgltf_node* nodeData, SdfPath path)
+  void Converter::authorDeferredReferences(const FileExports& fileExports, const SdfLayerHandle& layer)
   {
-    auto xform = UsdGeomXform::Define(m_stage, path);
+    for (const FileExport& fileExport : fileExports)
+    {
+      if (fileExport.referencingPrimPath.IsEmpty())
+      {
+        continue;
+      }
+
+      SdfPrimSpecHandle primSpec = layer->GetPrimAtPath(fileExport.referencingPrimPath);
+      if (!TF_VERIFY(primSpec))
+      {
+        continue;
+      }
+
+      // Like UsdReferences::AddReference, add it to the prepended references
+      primSpec->GetReferenceList().Prepend(SdfReference(fileExport.refPath, fileExport.referencedPrimPath));
+    }
+  }
+
+  void Converter::planNodes(const cgltf_node* rootNodeData, const SdfPath& parentPath, std::vector<NodePlan>& plans)
+  {
+    // Plan in depth-first pre-order with an explicit stack, so that deep hierarchies don't
+    // exhaust the call stack. Prims are later authored in this order, as the recursion did.
+    struct StackEntry
+    {
+      const cgltf_node* nodeData;
+      SdfPath parentPath;
+      // Composed transform and nearest name of folded transform-only ancestors
+      std::optional<GfMatrix4d> ancestorTransform;
+      const char* ancestorName;
+    };
+
+    std::vector<StackEntry> stack;
+    stack.push_back({ rootNodeData, parentPath, std::nullopt, nullptr });
+
+    while (!stack.empty())
+    {
+      StackEntry entry = std::move(stack.back());
+      stack.pop_back();
+
+      const cgltf_node* nodeData = entry.nodeData;
+      const char* name = nodeData->name ? nodeData->name : entry.ancestorName;
+
+      bool isTransformOnly = !nodeData->mesh && !nodeData->camera && !nodeData->light;
+      bool fold = isTransformOnly && ((m_params.transformMode == TransformMode::Collapse && nodeData->children_count == 1) ||
+                                      (m_params.transformMode == TransformMode::Flatten && nodeData->children_count > 0));
+
+      std::optional<GfMatrix4d> transform = entry.ancestorTransform;
+      if (fold || transform.has_value())
+      {
+        // Row vectors: the node's local transform is applied before its ancestors'
+        float m[16];
+        cgltf_node_transform_local(nodeData, m);
+
+        GfMatrix4d localTransform(
+          m[ 0], m[ 1], m[ 2], m[ 3],
+          m[ 4], m[ 5], m[ 6], m[ 7],
+          m[ 8], m[ 9], m[10], m[11],
+          m[12], m[13], m[14], m[15]
+        );
+
+        transform = transform.has_value() ? (localTransform * transform.value()) : localTransform;
+      }
+
+      if (fold)
+      {
+        for (size_t i = nodeData->children_count; i > 0; i--)
+        {
+          stack.push_back({ nodeData->children[i - 1], entry.parentPath, transform, name });
+        }
+        continue;
+      }
+
+      NodePlan plan;
+      plan.nodeData = nodeData;
+      plan.displayName = name;
+      plan.collapsedTransform = entry.ancestorTransform.has_value() ? transform : std::nullopt;
+
+      std::string baseName(name ? name : "node");
+      plan.path = m_pathRegistry.makeUniqueSubpath(entry.parentPath, baseName);
+
+      if (nodeData->mesh)
+      {
+        plan.meshName = nodeData->mesh->name ? std::string(nodeData->mesh->name) : "mesh";
+        plan.meshPath = m_pathRegistry.makeUniqueSubpath(plan.path, plan.meshName);
+      }
+
+      if (nodeData->camera)
+      {
+        plan.cameraName = nodeData->camera->name ? std::string(nodeData->camera->name) : "cam";
+        plan.cameraPath = m_pathRegistry.makeUniqueSubpath(plan.path, plan.cameraName);
+      }
+
+      if (nodeData->light)
+      {
+        plan.lightName = nodeData->light->name ? std::string(nodeData->light->name) : "light";
+        plan.lightPath = m_pathRegistry.makeUniqueSubpath(plan.path, plan.lightName);
+      }
+
+      // Reverse order so that children are popped, and thus named, in their original order
+      for (size_t i = nodeData->children_count; i > 0; i--)
+      {
+        stack.push_back({ nodeData->children[i - 1], plan.path, std::nullopt, nullptr });
+      }
+
+      plans.push_back(std::move(plan));
+    }
+  }
+
+  void Converter::createNodes(const std::vector<NodePlan>& plans)
+  {
+    // Xform specs of consecutive nodes share a change block. It is closed before meshes,
+    // cameras and lights are created, because they are authored using the Usd API.
+    std::optional<SdfChangeBlock> changeBlock;
+
+    for (size_t i = 0; i < plans.size(); i++)
+    {
+      const NodePlan& plan = plans[i];
+
+      if (!changeBlock)
+      {
+        changeBlock.emplace();
+      }
+
+      detail::PrimSpecWriter xform(m_stage, plan.path, _tokens->Xform);
+      if (!xform)
+      {
+        TF_RUNTIME_ERROR("unable to define Xform at path %s", plan.path.GetText());
+
+        // Skip the subtree, which directly follows in pre-order
+        while (i + 1 < plans.size() && plans[i + 1].path.HasPrefix(plan.path))
+        {
+          i++;
+        }
+        continue;
+      }
+
+      std::vector<XformOp> xformOps;
+      if (!plan.collapsedTransform.has_value())
+      {
+        createXformOps(plan.nodeData, xformOps);
+      }
+      else if (plan.collapsedTransform.value() != GfMatrix4d(1.0))
+      {
+        xformOps.push_back({ UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeTransform), SdfValueTypeNames->Matrix4d, VtValue(plan.collapsedTransform.value()) });
+      }
+
+      // Like UsdGeomXformable::AddXformOp, author xformOpOrder after the first op
+      VtTokenArray xformOpOrder;
+      for (const XformOp& op : xformOps)
+      {
+        xformOpOrder.push_back(op.name);
+      }
+
+      for (size_t j = 0; j < xformOps.size(); j++)
+      {
+        const XformOp& op = xformOps[j];
+        xform.createAttribute(op.name, op.typeName, op.value);
+
+        if (j == 0)
+        {
+          xform.createAttribute(UsdGeomTokens->xformOpOrder, SdfValueTypeNames->TokenArray, VtValue(xformOpOrder), SdfVariabilityUniform);
+        }
+      }
+
+      if (plan.displayName)
+      {
+        xform.setMetadata(SdfFieldKeys->DisplayName, VtValue(std::string(plan.displayName)));
+      }
+
+      if (plan.meshPath.IsEmpty() && plan.cameraPath.IsEmpty() && plan.lightPath.IsEmpty())
+      {
+        continue;
+      }
+
+      changeBlock.reset();
+
+      const cgltf_node* nodeData = plan.nodeData;
+
+      if (nodeData->mesh)
+      {
+        if (nodeData->has_mesh_gpu_instancing)
+        {
+          createPointInstancer(nodeData, plan.meshPath, plan.meshName);
+        }
+        else
+        {
+          createOrInstance(nodeData->mesh, plan.meshPath, EntryPathType::Meshes, plan.meshName, &Converter::createOrOverMesh);
+        }
+      }
+
+      if (nodeData->camera)
+      {
+        createOrInstance(nodeData->camera, plan.cameraPath, EntryPathType::Cameras, plan.cameraName, &Converter::createOrOverCamera);
+      }
+
+      if (nodeData->light)
+      {
+        createOrInstance(nodeData->light, plan.lightPath, EntryPathType::Lights, plan.lightName, &Converter::createOrOverLight);
+      }
+    }
+  }
 
+  void Converter::createXformOps(const cgltf_node* nodeData, std::vector<XformOp>& xformOps)
+  {
     if (nodeData->has_matrix)
     {
       const float* m = nodeData->matrix;
@@ -506,69 +949,218 @@ namespace guc
         m[12], m[13], m[14], m[15]
       );
 
-      auto op = xform.AddTransformOp(UsdGeomXformOp::PrecisionDouble);
-      op.Set(transform);
+      xformOps.push_back({ UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeTransform), SdfValueTypeNames->Matrix4d, VtValue(transform) });
     }
     else
     {
       if (nodeData->has_translation)
       {
-        auto op = xform.AddTranslateOp(UsdGeomXformOp::PrecisionFloat);
-        op.Set(GfVec3f(nodeData->translation));
+        xformOps.push_back({ UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeTranslate), SdfValueTypeNames->Float3, VtValue(GfVec3f(nodeData->translation)) });
       }
       if (nodeData->has_rotation)
       {
         // Express rotation using axis-angle
-        auto op = xform.AddOrientOp(UsdGeomXformOp::PrecisionFloat);
         GfQuatf rot(nodeData->rotation[3], GfVec3f(nodeData->rotation[0], nodeData->rotation[1], nodeData->rotation[2]));
-        op.Set(rot);
+        xformOps.push_back({ UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeOrient), SdfValueTypeNames->Quatf, VtValue(rot) });
       }
       if (nodeData->has_scale)
       {
-        auto op = xform.AddScaleOp(UsdGeomXformOp::PrecisionFloat);
-        op.Set(GfVec3f(nodeData->scale));
+        xformOps.push_back({ UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeScale), SdfValueTypeNames->Float3, VtValue(GfVec3f(nodeData->scale)) });
       }
     }
+  }
 
-    if (nodeData->mesh)
-    {
-      std::string meshName = nodeData->mesh->name ? std::string(nodeData->mesh->name) : "mesh";
-      auto meshPath = makeUniqueStageSubpath(m_stage, path, meshName);
+  void Converter::createPointInstancer(const cgltf_node* nodeData, SdfPath path, const std::string& meshName)
+  {
+    // EXT_mesh_gpu_instancing: instance transforms are relative to the node
+    const cgltf_mesh_gpu_instancing& instancing = nodeData->mesh_gpu_instancing;
 
-      createOrOverMesh(nodeData->mesh, meshPath);
-    }
+    VtVec3fArray translations;
+    VtVec4fArray rotations;
+    VtVec3fArray scales;
 
-    if (nodeData->camera)
+    for (size_t i = 0; i < instancing.attributes_count; i++)
     {
-      std::string camName = nodeData->camera->name ? std::string(nodeData->camera->name) : "cam";
-      auto camPath = makeUniqueStageSubpath(m_stage, path, camName);
+      const cgltf_attribute& attribute = instancing.attributes[i];
+      const cgltf_accessor* accessor = attribute.data;
 
-      createOrOverCamera(nodeData->camera, camPath);
-    }
+      bool result = true;
+      if (!strcmp(attribute.name, "TRANSLATION"))
+      {
+        result = detail::readVtArrayFromAccessor(m_data, accessor, translations);
+      }
+      else if (!strcmp(attribute.name, "ROTATION"))
+      {
+        result = detail::readVtArrayFromAccessor(m_data, accessor, rotations);
+      }
+      else if (!strcmp(attribute.name, "SCALE"))
+      {
+        result = detail::readVtArrayFromAccessor(m_data, accessor, scales);
+      }
+      else
+      {
+        TF_DEBUG(GUC).Msg("ignoring instance attribute %s\n", attribute.name);
+      }
+
+      if (!result)
+      {
+        TF_RUNTIME_ERROR("unable to read instance attribute %s", attribute.name);
+      }
+    }
+
+    size_t instanceCount = std::max({ translations.size(), rotations.size(), scales.size() });
+
+    if ((!translations.empty() && translations.size() != instanceCount) ||
+        (!rotations.empty() && rotations.size() != instanceCount) ||
+        (!scales.empty() && scales.size() != instanceCount))
+    {
+      TF_RUNTIME_ERROR("instance attribute counts do not match; skipping instances");
+      return;
+    }
+
+    auto instancer = UsdGeomPointInstancer::Define(m_stage, path);
+
+    // Prototypes below the instancer are only drawn through it
+    SdfPath prototypesPath = m_pathRegistry.makeUniqueSubpath(path, "Prototypes");
+    UsdGeomScope::Define(m_stage, prototypesPath);
+
+    SdfPath prototypePath = m_pathRegistry.makeUniqueSubpath(prototypesPath, meshName);
+    createOrInstance(nodeData->mesh, prototypePath, EntryPathType::Meshes, meshName, &Converter::createOrOverMesh);
+
+    instancer.CreatePrototypesRel().AddTarget(prototypePath);
+    instancer.CreateProtoIndicesAttr(VtValue(VtIntArray(instanceCount, 0)));
+
+    if (translations.empty())
+    {
+      translations.assign(instanceCount, GfVec3f(0.0f));
+    }
+    instancer.CreatePositionsAttr(VtValue(translations));
+
+    if (!rotations.empty())
+    {
+      VtQuathArray orientations(instanceCount);
+      const GfVec4f* rotationData = rotations.cdata();
+      for (size_t i = 0; i < instanceCount; i++)
+      {
+        const GfVec4f& r = rotationData[i]; // XYZW
+        orientations[i] = GfQuath(GfHalf(r[3]), GfVec3h(GfHalf(r[0]), GfHalf(r[1]), GfHalf(r[2])));
+      }
+      instancer.CreateOrientationsAttr(VtValue(orientations));
+    }
+
+    if (!scales.empty())
+    {
+      instancer.CreateScalesAttr(VtValue(scales));
+    }
+
+    VtVec3fArray extent;
+    if (instancer.ComputeExtentAtTime(&extent, UsdTimeCode::Default(), UsdTimeCode::Default()))
+    {
+      instancer.CreateExtentAttr(VtValue(extent));
+    }
+  }
+
+  void Converter::countInstanceUses(const cgltf_node* rootNodeData)
+  {
+    std::vector<const cgltf_node*> stack;
+    stack.push_back(rootNodeData);
+
+    while (!stack.empty())
+    {
+      const cgltf_node* nodeData = stack.back();
+      stack.pop_back();
+
+      if (nodeData->mesh)
+      {
+        m_instanceUseCounts[nodeData->mesh]++;
+      }
+      if (nodeData->camera)
+      {
+        m_instanceUseCounts[nodeData->camera]++;
+      }
+      if (nodeData->light)
+      {
+        m_instanceUseCounts[nodeData->light]++;
+      }
+
+      for (size_t i = 0; i < nodeData->children_count; i++)
+      {
+        stack.push_back(nodeData->children[i]);
+      }
+    }
+  }
 
-    if (nodeData->light)
+  void Converter::countAccessorUses()
+  {
+    for (size_t i = 0; i < m_data->meshes_count; i++)
     {
-      std::string lightName = nodeData->light->name ? std::string(nodeData->light->name) : "light";
-      auto lightPath = makeUniqueStageSubpath(m_stage, path, lightName);
+      const cgltf_mesh* meshData = &m_data->meshes[i];
+
+      for (size_t j = 0; j < meshData->primitives_count; j++)
+      {
+        const cgltf_primitive* primitiveData = &meshData->primitives[j];
+
+        if (primitiveData->indices)
+        {
+          m_accessorUseCounts[primitiveData->indices]++;
+        }
+        for (size_t k = 0; k < primitiveData->attributes_count; k++)
+        {
+          m_accessorUseCounts[primitiveData->attributes[k].data]++;
+        }
+      }
+    }
+  }
 
-      createOrOverLight(nodeData->light, lightPath);
+  template<typename T>
+  void Converter::createOrInstance(const T* data,
+                                   const SdfPath& path,
+                                   EntryPathType prototypeType,
+                                   const std::string& name,
+                                   void (Converter::*createOrOverFunc)(const T*, SdfPath))
+  {
+    auto useCountIter = m_instanceUseCounts.find(data);
+    if (!m_params.instancing || useCountIter == m_instanceUseCounts.end() || useCountIter->second < 2)
+    {
+      (this->*createOrOverFunc)(data, path);
+      return;
     }
 
-    for (size_t i = 0; i < nodeData->children_count; i++)
+    auto prototypeIter = m_prototypePaths.find(data);
+    if (prototypeIter == m_prototypePaths.end())
     {
-      const cgltf_node* childNodeData = nodeData->children[i];
+      // Prototypes are abstract class prims so that they are not traversed themselves
+      const SdfPath& prototypesPath = getEntryPath(prototypeType);
+      if (!m_stage->GetPrimAtPath(prototypesPath))
+      {
+        UsdGeomScope::Define(m_stage, prototypesPath);
+      }
+
+      SdfPath prototypePath = m_pathRegistry.makeUniqueSubpath(prototypesPath, name);
+      (this->*createOrOverFunc)(data, prototypePath);
 
-      std::string childName(childNodeData->name ? childNodeData->name : "node");
-      SdfPath childNodePath = makeUniqueStageSubpath(m_stage, path, childName);
+      UsdPrim prototype = m_stage->GetPrimAtPath(prototypePath);
+      if (prototype)
+      {
+        prototype.SetSpecifier(SdfSpecifierClass);
+      }
+      else
+      {
+        prototypePath = SdfPath::EmptyPath(); // invalid data
+      }
 
-      createNodesRecursively(childNodeData, childNodePath);
+      prototypeIter = m_prototypePaths.insert({ data, prototypePath }).first;
     }
 
-    if (nodeData->name)
+    const SdfPath& prototypePath = prototypeIter->second;
+    if (prototypePath.IsEmpty())
     {
-      UsdPrim prim = xform.GetPrim();
-      prim.SetDisplayName(nodeData->name);
+      return;
     }
+
+    UsdPrim prim = m_stage->DefinePrim(path);
+    prim.GetReferences().AddInternalReference(prototypePath);
+    prim.SetInstanceable(true);
   }
 
   void Converter::createOrOverCamera(const cgltf_camera* cameraData, SdfPath path)
@@ -693,17 +1285,24 @@ namespace guc
   {
     auto xform = UsdGeomXform::Define(m_stage, path);
 
+    if (m_params.mergePrimitives && meshData->primitives_count > 1)
+    {
+      createMergedPrimitives(meshData, path);
+      return;
+    }
+
     for (size_t i = 0; i < meshData->primitives_count; i++)
     {
       const cgltf_primitive* primitiveData = &meshData->primitives[i];
 
       std::string submeshName = (meshData->primitives_count == 1) ? "submesh" : ("submesh_" + std::to_string(i));
-      auto submeshPath = makeUniqueStageSubpath(m_stage, path, submeshName);
+      auto submeshPath = m_pathRegistry.makeUniqueSubpath(path, submeshName);
 
       UsdPrim submesh;
+      UsdPrim proxy;
       if (!overridePrimInPathMap((void*) primitiveData, submeshPath, submesh))
       {
-        if (!createPrimitive(primitiveData, submeshPath, submesh))
+        if (!createPrimitive(primitiveData, submeshPath, submesh, proxy))
         {
           TF_RUNTIME_ERROR("unable to create primitive; skipping");
           continue;
@@ -711,45 +1310,124 @@ namespace guc
 
         m_uniquePaths[(void*) primitiveData] = submeshPath;
       }
+      else if (auto proxyIter = m_proxyPaths.find(primitiveData); proxyIter != m_proxyPaths.end())
+      {
+        auto proxyPath = m_pathRegistry.makeUniqueSubpath(path, submeshName + "_proxy");
+        proxy = m_stage->OverridePrim(proxyPath);
+        proxy.GetReferences().AddReference("", proxyIter->second);
+      }
 
-      // Assign material (explicit, fallback, variants)
-      std::string materialName = DEFAULT_MATERIAL_NAME;
+      // The referenced relationship target lies outside of the referenced prim, so we always author it
+      if (proxy)
+      {
+        UsdGeomImageable(submesh).SetProxyPrim(proxy);
+      }
 
-      const auto getMaterialName = [&](const cgltf_material* material) {
-        int materialIndex = cgltf_material_index(m_data, material);
-        TF_VERIFY(materialIndex >= 0);
-        return m_materialNames[materialIndex].c_str();
-      };
+      createPrimitiveMaterialBindings(primitiveData, submesh, proxy);
 
-      if (primitiveData->material)
+      if (meshData->name)
       {
-        materialName = getMaterialName(primitiveData->material);
+        submesh.SetDisplayName(meshData->name);
       }
+    }
+  }
+
+  void Converter::createMergedPrimitives(const cgltf_mesh* meshData, const SdfPath& path)
+  {
+    std::vector<std::optional<PrimitiveGeometry>> geometries(meshData->primitives_count);
+
+    // Group the primitives on first use, so that overrides of the mesh reference the same prims
+    auto groupsIter = m_mergedPrimitiveIndices.find(meshData);
+    if (groupsIter == m_mergedPrimitiveIndices.end())
+    {
+      std::vector<std::vector<int>> groups;
 
-      if (primitiveData->mappings_count > 0)
+      for (size_t i = 0; i < meshData->primitives_count; i++)
       {
-        UsdPrim defaultPrim = m_stage->GetDefaultPrim();
-        UsdVariantSets variantSets = defaultPrim.GetVariantSets();
-        UsdVariantSet set = variantSets.GetVariantSet(getMaterialVariantSetName());
+        const cgltf_primitive* primitiveData = &meshData->primitives[i];
 
-        for (size_t j = 0; j < primitiveData->mappings_count; j++)
+        PrimitiveGeometry geometry;
+        if (!acquirePrimitiveGeometry(primitiveData, geometry))
         {
-          const cgltf_material_mapping* mapping = &primitiveData->mappings[j];
-          std::string variantName = normalizeVariantName(m_data->variants[mapping->variant].name);
+          TF_RUNTIME_ERROR("unable to create primitive; skipping");
+          continue;
+        }
+        geometries[i] = std::move(geometry);
+
+        // Join the first compatible group
+        auto groupIter = std::find_if(groups.begin(), groups.end(), [&](const std::vector<int>& group) {
+          int j = group[0];
+          return canMergePrimitives(&meshData->primitives[j], *geometries[j], primitiveData, *geometries[i]);
+        });
+
+        if (groupIter != groups.end())
+        {
+          groupIter->push_back(int(i));
+        }
+        else
+        {
+          groups.push_back({ int(i) });
+        }
+      }
+
+      TF_DEBUG(GUC).Msg("merged %d primitives into %d meshes\n", int(meshData->primitives_count), int(groups.size()));
 
-          TF_VERIFY(set.SetVariantSelection(variantName));
+      groupsIter = m_mergedPrimitiveIndices.insert({ meshData, std::move(groups) }).first;
+    }
+
+    const std::vector<std::vector<int>>& groups = groupsIter->second;
+
+    for (const std::vector<int>& primitiveIndices : groups)
+    {
+      const cgltf_primitive* firstPrimitiveData = &meshData->primitives[primitiveIndices[0]];
 
-          UsdEditContext editContext(set.GetVariantEditContext());
+      std::string submeshName = (groups.size() == 1) ? "submesh" : ("submesh_" + std::to_string(primitiveIndices[0]));
+      auto submeshPath = m_pathRegistry.makeUniqueSubpath(path, submeshName);
 
-          materialName = getMaterialName(mapping->material);
-          createMaterialBinding(submesh, materialName);
+      UsdPrim submesh;
+      UsdPrim proxy;
+      if (!overridePrimInPathMap((void*) firstPrimitiveData, submeshPath, submesh))
+      {
+        if (!createMergedPrimitive(meshData, primitiveIndices, geometries, submeshPath, submesh, proxy))
+        {
+          TF_RUNTIME_ERROR("unable to create primitive; skipping");
+          continue;
         }
 
-        TF_VERIFY(set.ClearVariantSelection());
+        m_uniquePaths[(void*) firstPrimitiveData] = submeshPath;
+      }
+      else if (auto proxyIter = m_proxyPaths.find(firstPrimitiveData); proxyIter != m_proxyPaths.end())
+      {
+        auto proxyPath = m_pathRegistry.makeUniqueSubpath(path, submeshName + "_proxy");
+        proxy = m_stage->OverridePrim(proxyPath);
+        proxy.GetReferences().AddReference("", proxyIter->second);
+      }
+
+      if (proxy)
+      {
+        UsdGeomImageable(submesh).SetProxyPrim(proxy);
+      }
+
+      if (primitiveIndices.size() == 1)
+      {
+        createPrimitiveMaterialBindings(firstPrimitiveData, submesh, proxy);
       }
       else
       {
-        createMaterialBinding(submesh, materialName);
+        // Materials are bound to the subsets, which overrides get through the reference
+        for (int primitiveIndex : primitiveIndices)
+        {
+          TfToken subsetName(makePrimitiveSubsetName(primitiveIndex));
+
+          UsdPrim subset = m_stage->OverridePrim(submesh.GetPath().AppendChild(subsetName));
+          UsdPrim proxySubset;
+          if (proxy)
+          {
+            proxySubset = m_stage->OverridePrim(proxy.GetPath().AppendChild(subsetName));
+          }
+
+          createPrimitiveMaterialBindings(&meshData->primitives[primitiveIndex], subset, proxySubset);
+        }
       }
 
       if (meshData->name)
@@ -759,6 +1437,57 @@ namespace guc
     }
   }
 
+  void Converter::createPrimitiveMaterialBindings(const cgltf_primitive* primitiveData, UsdPrim& prim, UsdPrim& proxyPrim)
+  {
+    const auto bindMaterial = [&](const std::string& materialName) {
+      createMaterialBinding(prim, materialName);
+      if (proxyPrim)
+      {
+        createMaterialBinding(proxyPrim, materialName);
+      }
+    };
+
+    // Assign material (explicit, fallback, variants)
+    std::string materialName = DEFAULT_MATERIAL_NAME;
+
+    const auto getMaterialName = [&](const cgltf_material* material) {
+      int materialIndex = cgltf_material_index(m_data, material);
+      TF_VERIFY(materialIndex >= 0);
+      return m_materialNames[materialIndex].c_str();
+    };
+
+    if (primitiveData->material)
+    {
+      materialName = getMaterialName(primitiveData->material);
+    }
+
+    if (primitiveData->mappings_count > 0)
+    {
+      UsdPrim defaultPrim = m_stage->GetDefaultPrim();
+      UsdVariantSets variantSets = defaultPrim.GetVariantSets();
+      UsdVariantSet set = variantSets.GetVariantSet(getMaterialVariantSetName());
+
+      for (size_t j = 0; j < primitiveData->mappings_count; j++)
+      {
+        const cgltf_material_mapping* mapping = &primitiveData->mappings[j];
+        std::string variantName = normalizeVariantName(m_data->variants[mapping->variant].name);
+
+        TF_VERIFY(set.SetVariantSelection(variantName));
+
+        UsdEditContext editContext(set.GetVariantEditContext());
+
+        materialName = getMaterialName(mapping->material);
+        bindMaterial(materialName);
+      }
+
+      TF_VERIFY(set.ClearVariantSelection());
+    }
+    else
+    {
+      bindMaterial(materialName);
+    }
+  }
+
   void Converter::createMaterialBinding(UsdPrim& prim, const std::string& materialName)
   {
     if (m_params.emitMtlx)
@@ -782,7 +1511,76 @@ namespace guc
     }
   }
 
-  bool Converter::createPrimitive(const cgltf_primitive* primitiveData, SdfPath path, UsdPrim& prim)
+  void Converter::decodePrimitives()
+  {
+    // Gather the primitives of all meshes that are referenced by converted nodes
+    std::vector<const cgltf_primitive*> primitives;
+    std::unordered_set<const cgltf_mesh*> visitedMeshes;
+    std::vector<const cgltf_node*> nodeStack;
+
+    if (m_data->scenes_count > 0)
+    {
+      for (size_t i = 0; i < m_data->scenes_count; i++)
+      {
+        const cgltf_scene* sceneData = &m_data->scenes[i];
+        nodeStack.insert(nodeStack.end(), sceneData->nodes, sceneData->nodes + sceneData->nodes_count);
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < m_data->nodes_count; i++)
+      {
+        nodeStack.push_back(&m_data->nodes[i]);
+      }
+    }
+
+    while (!nodeStack.empty())
+    {
+      const cgltf_node* nodeData = nodeStack.back();
+      nodeStack.pop_back();
+
+      const cgltf_mesh* meshData = nodeData->mesh;
+      if (meshData && visitedMeshes.insert(meshData).second)
+      {
+        for (size_t i = 0; i < meshData->primitives_count; i++)
+        {
+          primitives.push_back(&meshData->primitives[i]);
+        }
+      }
+
+      nodeStack.insert(nodeStack.end(), nodeData->children, nodeData->children + nodeData->children_count);
+    }
+
+    TF_DEBUG(GUC).Msg("decoding %d primitives in parallel\n", int(primitives.size()));
+
+    // Decoding only reads glTF data, writes to the task's own result slot and shares
+    // accessor data through the synchronized decode cache
+    std::vector<std::optional<PrimitiveGeometry>> results(primitives.size());
+    {
+      WorkDispatcher dispatcher;
+
+      for (size_t i = 0; i < primitives.size(); i++)
+      {
+        dispatcher.Run([this, &primitives, &results, i]()
+        {
+          PrimitiveGeometry geometry;
+          if (decodePrimitive(primitives[i], geometry))
+          {
+            results[i] = std::move(geometry);
+          }
+        });
+      }
+
+      dispatcher.Wait(); // also transports errors to this thread
+    }
+
+    for (size_t i = 0; i < primitives.size(); i++)
+    {
+      m_decodedPrimitives[primitives[i]] = std::move(results[i]);
+    }
+  }
+
+  bool Converter::decodePrimitive(const cgltf_primitive* primitiveData, PrimitiveGeometry& geometry) const
   {
     const cgltf_material* material = primitiveData->material;
 
@@ -793,12 +1591,12 @@ namespace guc
     }
 
     // Indices
-    VtIntArray indices;
+    VtIntArray& indices = geometry.indices;
     {
       const cgltf_accessor* accessor = primitiveData->indices;
       if (accessor)
       {
-        if (!detail::readVtArrayFromAccessor(accessor, indices))
+        if (!readCachedVtArray(accessor, indices))
         {
           TF_RUNTIME_ERROR("unable to read primitive indices");
           return false;
@@ -807,12 +1605,11 @@ namespace guc
     }
 
     // Points
-    VtVec3fArray points;
-    VtIntArray faceVertexCounts;
+    VtVec3fArray& points = geometry.points;
     {
       const cgltf_accessor* accessor = cgltf_find_accessor(primitiveData, "POSITION");
 
-      if (!detail::readVtArrayFromAccessor(accessor, points) || accessor->count == 0)
+      if (!accessor || !readCachedVtArray(accessor, points) || accessor->count == 0)
       {
         TF_RUNTIME_ERROR("invalid POSITION accessor");
         return false;
@@ -827,18 +1624,18 @@ namespace guc
       }
 
       VtIntArray newIndices;
-      if (!createGeometryRepresentation(primitiveData, indices, newIndices, faceVertexCounts))
+      if (!createGeometryRepresentation(primitiveData, indices, newIndices, geometry.faceVertexCounts))
       {
         TF_RUNTIME_ERROR("unable to create geometric representation");
         return false;
       }
-      indices = newIndices;
+      indices = std::move(newIndices);
     }
 
     // Colors
-    std::vector<VtVec3fArray> colorSets;
-    std::vector<VtFloatArray> opacitySets;
-    while (true)
+    std::vector<VtVec3fArray>& colorSets = geometry.colorSets;
+    std::vector<VtFloatArray>& opacitySets = geometry.opacitySets;
+    for (int setIndex = 0; ; setIndex++)
     {
       // The glTF PBR shading model which we implement using MaterialX requires us to
       // multiply the material's base color with the individual vertex colors.
@@ -857,7 +1654,7 @@ namespace guc
       // consistent with the displayColor and displayOpacity primvars.
 
       TF_VERIFY(colorSets.size() == opacitySets.size());
-      std::string name = "COLOR_" + std::to_string(colorSets.size());
+      std::string name = "COLOR_" + std::to_string(setIndex);
 
       const cgltf_accessor* accessor = cgltf_find_accessor(primitiveData, name.c_str());
       if (!accessor)
@@ -865,58 +1662,47 @@ namespace guc
         break;
       }
 
+      // Unreadable sets are kept as empty placeholders so that the primvar names stay
+      // in sync with the glTF set indices. Empty sets are not authored.
       VtVec3fArray colors;
       VtFloatArray opacities;
 
       if (accessor->type == cgltf_type_vec3)
       {
-        if (!detail::readVtArrayFromAccessor(accessor, colors))
+        if (!readCachedVtArray(accessor, colors))
         {
           TF_RUNTIME_ERROR("can't read %s attribute; ignoring", name.c_str());
-          continue;
+          colors.clear();
         }
       }
       else if (accessor->type == cgltf_type_vec4)
       {
         VtVec4fArray rgbaColors;
-        if (!detail::readVtArrayFromAccessor(accessor, rgbaColors))
+        if (!readCachedVtArray(accessor, rgbaColors))
         {
           TF_RUNTIME_ERROR("can't read %s attribute; ignoring", name.c_str());
-          continue;
-        }
-
-        size_t rgbaColorCount = rgbaColors.size();
-
-        colors.resize(rgbaColorCount);
-        for (size_t k = 0; k < rgbaColorCount; k++)
-        {
-          colors[k] = GfVec3f(rgbaColors[k].data());
+          rgbaColors.clear();
         }
 
         // Optimization: if material is opaque, we don't read the opacities anyway
-        if (material->alpha_mode != cgltf_alpha_mode_opaque)
-        {
-          opacities.resize(rgbaColorCount);
-          for (size_t k = 0; k < rgbaColorCount; k++)
-          {
-            opacities[k] = rgbaColors[k][3];
-          }
-        }
+        bool readOpacities = material->alpha_mode != cgltf_alpha_mode_opaque;
+
+        splitVec4Array(rgbaColors, colors, readOpacities ? &opacities : nullptr);
       }
       else
       {
-        TF_RUNTIME_ERROR("invalid COLOR attribute type; ignoring");
-        continue;
+        TF_RUNTIME_ERROR("invalid %s attribute type; ignoring", name.c_str());
       }
 
       colorSets.push_back(colors);
       opacitySets.push_back(opacities);
+      geometry.halfColorSets.push_back(useHalfPrecision(accessor));
     }
 
     // Display colors and opacities
-    VtVec3fArray displayColors;
-    VtFloatArray displayOpacities;
-    bool generatedDisplayColors = false;
+    VtVec3fArray& displayColors = geometry.displayColors;
+    VtFloatArray& displayOpacities = geometry.displayOpacities;
+    bool& generatedDisplayColors = geometry.generatedDisplayColors;
 
     if (!colorSets.empty())
     {
@@ -943,21 +1729,15 @@ namespace guc
 
       const cgltf_pbr_metallic_roughness* pbr_metallic_roughness = &material->pbr_metallic_roughness;
 
-      for (GfVec3f& c : displayColors)
-      {
-        c = GfCompMult(c, GfVec3f(pbr_metallic_roughness->base_color_factor));
-      }
-      for (float& o : displayOpacities)
-      {
-        o *= pbr_metallic_roughness->base_color_factor[3];
-      }
+      multiplyComponents(displayColors, GfVec3f(pbr_metallic_roughness->base_color_factor));
+      multiplyValues(displayOpacities, pbr_metallic_roughness->base_color_factor[3]);
     }
 
     // TexCoord sets
-    std::vector<VtVec2fArray> texCoordSets;
-    while (true)
+    std::vector<VtVec2fArray>& texCoordSets = geometry.texCoordSets;
+    for (int setIndex = 0; ; setIndex++)
     {
-      std::string name = "TEXCOORD_" + std::to_string(texCoordSets.size());
+      std::string name = "TEXCOORD_" + std::to_string(setIndex);
 
       const cgltf_accessor* accessor = cgltf_find_accessor(primitiveData, name.c_str());
       if (!accessor)
@@ -965,49 +1745,53 @@ namespace guc
         break;
       }
 
-      VtVec2fArray texCoords;
-      if (!detail::readVtArrayFromAccessor(accessor, texCoords))
-      {
-        continue;
-      }
-
       // Y values need to be flipped
-      for (GfVec2f& texCoord : texCoords)
+      VtVec2fArray texCoords;
+      if (!readCachedVtArray(accessor, texCoords, AccessorTransform::FlipTexCoordsY))
       {
-        texCoord[1] = 1.0f - texCoord[1];
+        // Keep an empty placeholder so that subsequent sets retain their index
+        TF_RUNTIME_ERROR("can't read %s attribute; ignoring", name.c_str());
+        texCoords.clear();
       }
 
       texCoordSets.push_back(texCoords);
+      geometry.halfTexCoordSets.push_back(useHalfPrecision(accessor));
     }
 
     // Normals and Tangents
-    VtVec3fArray normals;
+    VtVec3fArray& normals = geometry.normals;
 
-    const auto deindexPrimvarsExceptTangents = [&]()
+    // Replaces the vertices by the vertices at the given source indices
+    const auto gatherPrimvarsExceptTangents = [&](const VtIntArray& sourceIndices)
     {
-      detail::deindexVtArray(indices, points);
-      detail::deindexVtArray(indices, normals);
+      detail::deindexVtArray(sourceIndices, points);
+      detail::deindexVtArray(sourceIndices, normals);
 
       for (VtVec2fArray& texCoords : texCoordSets)
       {
-        detail::deindexVtArray(indices, texCoords);
+        detail::deindexVtArray(sourceIndices, texCoords);
       }
       for (VtVec3fArray& colors : colorSets)
       {
-        detail::deindexVtArray(indices, colors);
+        detail::deindexVtArray(sourceIndices, colors);
       }
       for (VtFloatArray& opacities : opacitySets)
       {
-        detail::deindexVtArray(indices, opacities);
+        detail::deindexVtArray(sourceIndices, opacities);
       }
       if (!generatedDisplayColors) // constant interpolation
       {
-        detail::deindexVtArray(indices, displayColors);
+        detail::deindexVtArray(sourceIndices, displayColors);
       }
       if (!generatedDisplayColors) // constant interpolation
       {
-        detail::deindexVtArray(indices, displayOpacities);
+        detail::deindexVtArray(sourceIndices, displayOpacities);
       }
+    };
+
+    const auto deindexPrimvarsExceptTangents = [&]()
+    {
+      gatherPrimvarsExceptTangents(indices);
 
       for (size_t i = 0; i < indices.size(); i++)
       {
@@ -1015,48 +1799,35 @@ namespace guc
       }
     };
 
-    bool hasTriangleTopology = primitiveData->type == cgltf_primitive_type_triangles ||
-                               primitiveData->type == cgltf_primitive_type_triangle_strip ||
-                               primitiveData->type == cgltf_primitive_type_triangle_fan;
+    bool hasTriangleTopology = detail::hasTriangleTopology(primitiveData);
 
-    bool generatedNormals = false;
+    // In face-varying mode, points and primvars stay indexed and generated attributes
+    // are written as indexed face-varying primvars instead of de-indexing the mesh.
+    bool faceVarying = m_params.faceVaryingPrimvars && hasTriangleTopology;
+
+    bool generateNormals = false;
     {
       const cgltf_accessor* accessor = cgltf_find_accessor(primitiveData, "NORMAL");
 
-      if (!accessor || !detail::readVtArrayFromAccessor(accessor, normals))
+      if (!accessor || !readCachedVtArray(accessor, normals))
       {
-        if (hasTriangleTopology) // generate fallback normals (spec sec. 3.7.2.1)
-        {
-          TF_DEBUG(GUC).Msg("normals do not exist; calculating flat normals\n");
-
-          // For flat normals, vertex normals can not be shared among triangles.
-          deindexPrimvarsExceptTangents();
-
-          createFlatNormals(indices, points, normals);
-
-          generatedNormals = true;
-        }
+        generateNormals = hasTriangleTopology; // generate fallback normals (spec sec. 3.7.2.1)
       }
     }
 
-    VtVec3fArray tangents;
-    VtFloatArray bitangentSigns;
-    bool generatedTangents = false;
+    VtVec3fArray& tangents = geometry.tangents;
+    VtFloatArray& bitangentSigns = geometry.bitangentSigns;
+    const VtVec2fArray* tangentTexCoords = nullptr;
     {
       const cgltf_accessor* accessor = cgltf_find_accessor(primitiveData, "TANGENT");
-      if (!generatedNormals && accessor) // according to glTF spec 3.7.2.1, tangents must be ignored if normals are missing
+      if (!generateNormals && accessor) // according to glTF spec 3.7.2.1, tangents must be ignored if normals are missing
       {
         VtVec4fArray tangentsWithW;
-        if (detail::readVtArrayFromAccessor(accessor, tangentsWithW))
+        if (readCachedVtArray(accessor, tangentsWithW))
         {
-          tangents.resize(tangentsWithW.size());
-          bitangentSigns.resize(tangentsWithW.size());
+          splitVec4Array(tangentsWithW, tangents, &bitangentSigns);
 
-          for (size_t i = 0; i < tangentsWithW.size(); i++)
-          {
-            tangents[i] = GfVec3f(tangentsWithW[i].data());
-            bitangentSigns[i] = tangentsWithW[i][3];
-          }
+          geometry.halfTangents = useHalfPrecision(accessor);
         }
       }
       else if (hasTriangleTopology && m_params.emitMtlx)
@@ -1067,21 +1838,9 @@ namespace guc
         {
           int texCoordSetCount = int(texCoordSets.size());
 
-          if (textureView.texcoord < texCoordSetCount)
+          if (textureView.texcoord < texCoordSetCount && !texCoordSets[textureView.texcoord].empty())
           {
-            TF_DEBUG(GUC).Msg("generating tangents\n");
-
-            const VtVec2fArray& texCoords = texCoordSets[textureView.texcoord];
-            createTangents(indices, points, normals, texCoords, bitangentSigns, tangents);
-
-            // The generated tangents are unindexed, which means that we
-            // have to deindex all other primvars and reindex the mesh.
-            if (!generatedNormals)
-            {
-              deindexPrimvarsExceptTangents();
-            }
-
-            generatedTangents = true;
+            tangentTexCoords = &texCoordSets[textureView.texcoord];
           }
           else
           {
@@ -1091,140 +1850,729 @@ namespace guc
       }
     }
 
-    // Create GPrim and assign values
-    auto mesh = UsdGeomMesh::Define(m_stage, path);
-    auto primvarsApi = UsdGeomPrimvarsAPI(mesh);
-
-    mesh.CreateSubdivisionSchemeAttr(VtValue(UsdGeomTokens->none));
-
-    if (material->double_sided)
+    // Face-varying index arrays follow the face order, so the mesh has to be optimized
+    // before generating them.
+    bool optimize = m_params.optimizeMeshes && hasTriangleTopology;
+    if (optimize && faceVarying)
     {
-      mesh.CreateDoubleSidedAttr(VtValue(true));
+      optimizePrimitive(geometry);
     }
 
-    if (!indices.empty())
+    bool& generatedNormals = geometry.generatedNormals;
+    if (generateNormals)
     {
-      auto attr = mesh.CreateFaceVertexIndicesAttr(VtValue(indices));
+      TF_DEBUG(GUC).Msg("normals do not exist; calculating flat normals\n");
 
-      // If we generated normals or tangents, we have re-indexed the mesh. This means
-      // that we have de-indexed all other primvars; but unlike the indices, their data
-      // still exists and is just encoded in a different way. This is why we only add
-      // the "generated" custom data to the indices.
-      if (generatedNormals || generatedTangents)
+      if (faceVarying)
       {
-        detail::markAttributeAsGenerated(attr);
+        createFlatNormals(indices, points, normals, geometry.normalIndices);
       }
-    }
-    mesh.CreatePointsAttr(VtValue(points));
-    mesh.CreateFaceVertexCountsAttr(VtValue(faceVertexCounts));
-
-    if (!normals.empty())
-    {
-      auto attr = mesh.CreateNormalsAttr(VtValue(normals));
-      mesh.SetNormalsInterpolation(UsdGeomTokens->vertex);
-
-      if (generatedNormals)
+      else
       {
-        detail::markAttributeAsGenerated(attr);
+        // For flat normals, vertex normals can not be shared among triangles.
+        deindexPrimvarsExceptTangents();
+
+        createFlatNormals(indices, points, normals);
       }
-    }
 
-    VtVec3fArray extent;
-    if (UsdGeomPointBased::ComputeExtent(points, &extent))
-    {
-      mesh.CreateExtentAttr(VtValue(extent));
-    }
-    else
-    {
-      TF_WARN("unable to compute extent for mesh");
+      generatedNormals = true;
     }
 
-    // There is no formal schema for tangents and tangent signs/bitangents, so we define our own primvars
-    if (!tangents.empty())
+    bool& generatedTangents = geometry.generatedTangents;
+    if (tangentTexCoords)
     {
-      auto primvar = primvarsApi.CreatePrimvar(UsdGeomTokens->tangents, SdfValueTypeNames->Float3Array, UsdGeomTokens->vertex);
-      primvar.Set(tangents);
+      TF_DEBUG(GUC).Msg("generating tangents\n");
+
+      const VtIntArray& normalIndices = geometry.normalIndices.empty() ? indices : geometry.normalIndices;
+      createTangents(indices, points, normals, normalIndices, *tangentTexCoords, bitangentSigns, tangents, m_params.multithreaded);
+      geometry.halfTangents = (m_params.primvarPrecision == PrimvarPrecision::Half);
 
-      if (generatedTangents)
+      if (faceVarying)
       {
-        detail::markAttributeAsGenerated(primvar);
-      }
-    }
-    if (!bitangentSigns.empty())
-    {
-      auto primvar = primvarsApi.CreatePrimvar(_tokens->bitangentSigns, SdfValueTypeNames->FloatArray, UsdGeomTokens->vertex);
-      primvar.Set(bitangentSigns);
+        // Only corners with distinct tangent frames get their own value.
+        std::vector<unsigned int> remap;
+        size_t tangentCount = generateUniqueElementRemap({ { tangents.cdata(), sizeof(GfVec3f) },
+                                                           { bitangentSigns.cdata(), sizeof(float) } },
+                                                         tangents.size(), remap);
 
-      if (generatedTangents)
+        geometry.tangentIndices = VtIntArray(remap.begin(), remap.end());
+        remapVertexArray(tangents, remap, tangentCount);
+        remapVertexArray(bitangentSigns, remap, tangentCount);
+      }
+      // The generated tangents are unindexed. Instead of de-indexing all other primvars,
+      // we only split the vertices whose tangent frames differ between face corners.
+      // With generated flat normals, the mesh has already been de-indexed.
+      else if (!generatedNormals)
       {
-        detail::markAttributeAsGenerated(primvar);
+        VtIntArray sourceVertices;
+        weldTangentFrames(indices, tangents, bitangentSigns, sourceVertices);
+
+        gatherPrimvarsExceptTangents(sourceVertices);
       }
+
+      generatedTangents = true;
     }
 
-    for (size_t i = 0; i < texCoordSets.size(); i++)
+    if (optimize && !faceVarying)
     {
-      const VtVec2fArray& texCoords = texCoordSets[i];
-      if (texCoords.empty())
-      {
-        continue;
+      optimizePrimitive(geometry);
+    }
+
+    return true;
+  }
+
+  void Converter::optimizePrimitive(PrimitiveGeometry& geometry) const
+  {
+    std::vector<VertexStream> streams;
+    getVertexStreams(geometry, streams);
+
+    std::vector<unsigned int> remap;
+    size_t newVertexCount;
+    optimizeTriangleMesh(geometry.indices, geometry.points, streams, remap, newVertexCount);
+
+    geometry.faceVertexCounts = VtIntArray(geometry.indices.size() / 3, 3);
+
+    remapPrimitiveVertices(geometry, remap, newVertexCount);
+  }
+
+  void Converter::getVertexStreams(const PrimitiveGeometry& geometry, std::vector<VertexStream>& streams)
+  {
+    size_t vertexCount = geometry.points.size();
+
+    // Constant primvars, like generated display colors, are not remapped
+    const auto addStream = [&](const auto& arr)
+    {
+      if (arr.size() == vertexCount)
+      {
+        streams.push_back({ arr.cdata(), sizeof(arr.cdata()[0]) });
       }
-      auto primvarId = TfToken(makeStSetName(i));
-      auto primvar = primvarsApi.CreatePrimvar(primvarId, SdfValueTypeNames->TexCoord2fArray, UsdGeomTokens->vertex);
-      primvar.Set(texCoords);
+    };
+
+    addStream(geometry.normals);
+    addStream(geometry.tangents);
+    addStream(geometry.bitangentSigns);
+    for (const VtVec2fArray& texCoords : geometry.texCoordSets)
+    {
+      addStream(texCoords);
+    }
+    for (const VtVec3fArray& colors : geometry.colorSets)
+    {
+      addStream(colors);
+    }
+    for (const VtFloatArray& opacities : geometry.opacitySets)
+    {
+      addStream(opacities);
     }
+    addStream(geometry.displayColors);
+    addStream(geometry.displayOpacities);
+  }
+
+  void Converter::remapPrimitiveVertices(PrimitiveGeometry& geometry, const std::vector<unsigned int>& remap, size_t newVertexCount)
+  {
+    size_t vertexCount = geometry.points.size();
 
-    for (size_t i = 0; i < colorSets.size(); i++)
+    // Constant primvars, like generated display colors, are not remapped
+    const auto remapArray = [&](auto& arr)
     {
-      const VtVec3fArray& colors = colorSets[i];
-      if (colors.empty())
+      if (arr.size() == vertexCount)
       {
-        continue;
+        remapVertexArray(arr, remap, newVertexCount);
       }
-      auto colorPrimvarId = TfToken(makeColorSetName(i));
-      auto colorPrimvar = primvarsApi.CreatePrimvar(colorPrimvarId, SdfValueTypeNames->Float3Array, UsdGeomTokens->vertex);
-      colorPrimvar.Set(colors);
+    };
+
+    remapArray(geometry.normals);
+    remapArray(geometry.tangents);
+    remapArray(geometry.bitangentSigns);
+    for (VtVec2fArray& texCoords : geometry.texCoordSets)
+    {
+      remapArray(texCoords);
+    }
+    for (VtVec3fArray& colors : geometry.colorSets)
+    {
+      remapArray(colors);
+    }
+    for (VtFloatArray& opacities : geometry.opacitySets)
+    {
+      remapArray(opacities);
+    }
+    remapArray(geometry.displayColors);
+    remapArray(geometry.displayOpacities);
+    remapArray(geometry.points); // last, as it defines the vertex count
+  }
+
+  bool Converter::createProxyGeometry(const PrimitiveGeometry& geometry, PrimitiveGeometry& proxyGeometry) const
+  {
+    proxyGeometry = geometry; // VtArrays share their data until they are written to
+
+    // Face-varying values are tied to the original faces
+    if (!geometry.normalIndices.empty())
+    {
+      proxyGeometry.normals = VtVec3fArray();
+      proxyGeometry.normalIndices = VtIntArray();
+      proxyGeometry.generatedNormals = false;
+    }
+    if (!geometry.tangentIndices.empty())
+    {
+      proxyGeometry.tangents = VtVec3fArray();
+      proxyGeometry.bitangentSigns = VtFloatArray();
+      proxyGeometry.tangentIndices = VtIntArray();
+      proxyGeometry.generatedTangents = false;
+    }
 
-      // We do an emptyness check here instead of in the retrieval routine above
-      // in order to keep the color-opacity primvar index correspondence, e.g.:
-      //  color1, opacity1
-      //  color2, (missing)
-      //  color3, opacity3
-      const VtFloatArray& opacities = opacitySets[i];
-      if (opacities.empty())
+    std::vector<unsigned int> remap;
+    size_t newVertexCount;
+    if (!simplifyTriangleMesh(proxyGeometry.indices, proxyGeometry.points, m_params.proxyRatio, remap, newVertexCount))
+    {
+      return false;
+    }
+
+    proxyGeometry.faceVertexCounts = VtIntArray(proxyGeometry.indices.size() / 3, 3);
+
+    remapPrimitiveVertices(proxyGeometry, remap, newVertexCount);
+    return true;
+  }
+
+  bool Converter::acquirePrimitiveGeometry(const cgltf_primitive* primitiveData, PrimitiveGeometry& geometry)
+  {
+    auto decodedIter = m_decodedPrimitives.find(primitiveData);
+    if (decodedIter == m_decodedPrimitives.end())
+    {
+      return decodePrimitive(primitiveData, geometry);
+    }
+
+    std::optional<PrimitiveGeometry> decodedGeometry = std::move(decodedIter->second);
+    m_decodedPrimitives.erase(decodedIter);
+
+    if (!decodedGeometry.has_value())
+    {
+      return false;
+    }
+    geometry = std::move(decodedGeometry.value());
+    return true;
+  }
+
+  bool Converter::createPrimitive(const cgltf_primitive* primitiveData, SdfPath path, UsdPrim& prim, UsdPrim& proxyPrim)
+  {
+    PrimitiveGeometry geometry;
+    if (!acquirePrimitiveGeometry(primitiveData, geometry))
+    {
+      return false;
+    }
+
+    const cgltf_material* material = primitiveData->material ? primitiveData->material : &DEFAULT_MATERIAL;
+
+    createMesh(geometry, material, path, prim);
+
+    bool hasTriangleTopology = detail::hasTriangleTopology(primitiveData);
+
+    PrimitiveGeometry proxyGeometry;
+    if (m_params.proxyRatio > 0.0f && hasTriangleTopology && createProxyGeometry(geometry, proxyGeometry))
+    {
+      auto proxyPath = m_pathRegistry.makeUniqueSubpath(path.GetParentPath(), path.GetName() + "_proxy");
+      createMesh(proxyGeometry, material, proxyPath, proxyPrim);
+
+      UsdGeomImageable(prim).CreatePurposeAttr(VtValue(UsdGeomTokens->render));
+      UsdGeomImageable(proxyPrim).CreatePurposeAttr(VtValue(UsdGeomTokens->proxy));
+
+      m_proxyPaths[primitiveData] = proxyPath;
+    }
+
+    return true;
+  }
+
+  bool Converter::canMergePrimitives(const cgltf_primitive* primitiveDataA,
+                                     const PrimitiveGeometry& geometryA,
+                                     const cgltf_primitive* primitiveDataB,
+                                     const PrimitiveGeometry& geometryB) const
+  {
+    // Subsets and proxies are only supported for faces
+    if (!detail::hasTriangleTopology(primitiveDataA) || !detail::hasTriangleTopology(primitiveDataB))
+    {
+      return false;
+    }
+
+    const cgltf_material* materialA = primitiveDataA->material ? primitiveDataA->material : &DEFAULT_MATERIAL;
+    const cgltf_material* materialB = primitiveDataB->material ? primitiveDataB->material : &DEFAULT_MATERIAL;
+    if (materialA->double_sided != materialB->double_sided)
+    {
+      return false;
+    }
+
+    const PrimitiveGeometry& a = geometryA;
+    const PrimitiveGeometry& b = geometryB;
+
+    if (a.normalIndices.empty() != b.normalIndices.empty() ||
+        a.tangentIndices.empty() != b.tangentIndices.empty() ||
+        a.generatedNormals != b.generatedNormals ||
+        a.generatedTangents != b.generatedTangents ||
+        a.generatedDisplayColors != b.generatedDisplayColors ||
+        a.halfTangents != b.halfTangents ||
+        a.halfTexCoordSets != b.halfTexCoordSets ||
+        a.halfColorSets != b.halfColorSets ||
+        a.texCoordSets.size() != b.texCoordSets.size() ||
+        a.colorSets.size() != b.colorSets.size() ||
+        a.opacitySets.size() != b.opacitySets.size())
+    {
+      return false;
+    }
+
+    // Primvars must either be missing, per-vertex, or constant with equal values in both
+    const auto isCompatible = [&](const auto& arrA, const auto& arrB)
+    {
+      bool perVertexA = !arrA.empty() && arrA.size() == a.points.size();
+      bool perVertexB = !arrB.empty() && arrB.size() == b.points.size();
+      return perVertexA == perVertexB && (perVertexA || arrA == arrB);
+    };
+
+    // Face-varying values are indexed separately and always concatenated
+    if (a.normalIndices.empty() && !isCompatible(a.normals, b.normals))
+    {
+      return false;
+    }
+    if (a.tangentIndices.empty() && (!isCompatible(a.tangents, b.tangents) || !isCompatible(a.bitangentSigns, b.bitangentSigns)))
+    {
+      return false;
+    }
+    if (!a.tangentIndices.empty() && a.bitangentSigns.empty() != b.bitangentSigns.empty())
+    {
+      return false;
+    }
+    for (size_t i = 0; i < a.texCoordSets.size(); i++)
+    {
+      if (!isCompatible(a.texCoordSets[i], b.texCoordSets[i]))
       {
-        continue;
+        return false;
+      }
+    }
+    for (size_t i = 0; i < a.colorSets.size(); i++)
+    {
+      if (!isCompatible(a.colorSets[i], b.colorSets[i]) || !isCompatible(a.opacitySets[i], b.opacitySets[i]))
+      {
+        return false;
+      }
+    }
+    return isCompatible(a.displayColors, b.displayColors) && isCompatible(a.displayOpacities, b.displayOpacities);
+  }
+
+  void Converter::mergePrimitiveGeometries(const std::vector<const PrimitiveGeometry*>& parts, PrimitiveGeometry& merged)
+  {
+    const PrimitiveGeometry& first = *parts[0];
+
+    if (parts.size() == 1)
+    {
+      merged = first;
+      return;
+    }
+
+    merged.halfTexCoordSets = first.halfTexCoordSets;
+    merged.halfColorSets = first.halfColorSets;
+    merged.halfTangents = first.halfTangents;
+    merged.generatedNormals = first.generatedNormals;
+    merged.generatedTangents = first.generatedTangents;
+    merged.generatedDisplayColors = first.generatedDisplayColors;
+    merged.texCoordSets.resize(first.texCoordSets.size());
+    merged.colorSets.resize(first.colorSets.size());
+    merged.opacitySets.resize(first.opacitySets.size());
+
+    const auto appendValues = [](auto& dst, const auto& src)
+    {
+      size_t offset = dst.size();
+      dst.resize(offset + src.size());
+      std::copy(src.cbegin(), src.cend(), dst.begin() + offset);
+    };
+
+    const auto appendIndices = [](VtIntArray& dst, const VtIntArray& src, int indexOffset)
+    {
+      size_t offset = dst.size();
+      dst.resize(offset + src.size());
+      for (size_t i = 0; i < src.size(); i++)
+      {
+        dst[offset + i] = src[i] + indexOffset;
+      }
+    };
+
+    // Constant values are equal for all parts, as checked by canMergePrimitives
+    const auto appendPrimvar = [&](auto& dst, const auto& src, size_t vertexCount)
+    {
+      if (src.size() == vertexCount)
+      {
+        appendValues(dst, src);
+      }
+      else if (dst.empty())
+      {
+        dst = src;
+      }
+    };
+
+    for (const PrimitiveGeometry* part : parts)
+    {
+      size_t vertexCount = part->points.size();
+
+      appendIndices(merged.indices, part->indices, int(merged.points.size()));
+      appendValues(merged.faceVertexCounts, part->faceVertexCounts);
+
+      if (!part->normalIndices.empty())
+      {
+        appendIndices(merged.normalIndices, part->normalIndices, int(merged.normals.size()));
+        appendValues(merged.normals, part->normals);
+      }
+      else
+      {
+        appendPrimvar(merged.normals, part->normals, vertexCount);
+      }
+
+      if (!part->tangentIndices.empty())
+      {
+        appendIndices(merged.tangentIndices, part->tangentIndices, int(merged.tangents.size()));
+        appendValues(merged.tangents, part->tangents);
+        appendValues(merged.bitangentSigns, part->bitangentSigns);
+      }
+      else
+      {
+        appendPrimvar(merged.tangents, part->tangents, vertexCount);
+        appendPrimvar(merged.bitangentSigns, part->bitangentSigns, vertexCount);
+      }
+
+      for (size_t i = 0; i < part->texCoordSets.size(); i++)
+      {
+        appendPrimvar(merged.texCoordSets[i], part->texCoordSets[i], vertexCount);
+      }
+      for (size_t i = 0; i < part->colorSets.size(); i++)
+      {
+        appendPrimvar(merged.colorSets[i], part->colorSets[i], vertexCount);
+        appendPrimvar(merged.opacitySets[i], part->opacitySets[i], vertexCount);
+      }
+      appendPrimvar(merged.displayColors, part->displayColors, vertexCount);
+      appendPrimvar(merged.displayOpacities, part->displayOpacities, vertexCount);
+
+      appendValues(merged.points, part->points); // last, as it defines the vertex offset
+    }
+
+    // Share identical vertices between the parts. Face-varying values are not per-vertex,
+    // so they are set aside in case their count happens to match the vertex count.
+    VtVec3fArray faceVaryingNormals;
+    VtVec3fArray faceVaryingTangents;
+    VtFloatArray faceVaryingBitangentSigns;
+    if (!merged.normalIndices.empty())
+    {
+      std::swap(merged.normals, faceVaryingNormals);
+    }
+    if (!merged.tangentIndices.empty())
+    {
+      std::swap(merged.tangents, faceVaryingTangents);
+      std::swap(merged.bitangentSigns, faceVaryingBitangentSigns);
+    }
+
+    std::vector<VertexStream> streams;
+    streams.push_back({ merged.points.cdata(), sizeof(GfVec3f) });
+    getVertexStreams(merged, streams);
+
+    size_t vertexCount = merged.points.size();
+    std::vector<unsigned int> remap;
+    size_t uniqueVertexCount = generateUniqueElementRemap(streams, vertexCount, remap);
+
+    if (uniqueVertexCount < vertexCount)
+    {
+      TF_DEBUG(GUC).Msg("shared %d of %d vertices between merged primitives\n", int(vertexCount - uniqueVertexCount), int(vertexCount));
+
+      int* indexData = merged.indices.data();
+      for (size_t i = 0; i < merged.indices.size(); i++)
+      {
+        indexData[i] = int(remap[indexData[i]]);
       }
-      auto opacityPrimvarId = TfToken(makeOpacitySetName(i));
-      auto opacityPrimvar = primvarsApi.CreatePrimvar(opacityPrimvarId, SdfValueTypeNames->FloatArray, UsdGeomTokens->vertex);
-      opacityPrimvar.Set(opacities);
+
+      remapPrimitiveVertices(merged, remap, uniqueVertexCount);
     }
 
-    TfToken displayPrimvarInterpolation = generatedDisplayColors ? UsdGeomTokens->constant : UsdGeomTokens->vertex;
-    if (!displayColors.empty())
+    if (!merged.normalIndices.empty())
     {
-      auto primvar = mesh.CreateDisplayColorPrimvar(displayPrimvarInterpolation);
-      primvar.Set(displayColors);
+      std::swap(merged.normals, faceVaryingNormals);
+    }
+    if (!merged.tangentIndices.empty())
+    {
+      std::swap(merged.tangents, faceVaryingTangents);
+      std::swap(merged.bitangentSigns, faceVaryingBitangentSigns);
+    }
+  }
 
-      if (generatedDisplayColors)
+  bool Converter::createMergedPrimitive(const cgltf_mesh* meshData,
+                                        const std::vector<int>& primitiveIndices,
+                                        std::vector<std::optional<PrimitiveGeometry>>& geometries,
+                                        const SdfPath& path,
+                                        UsdPrim& prim,
+                                        UsdPrim& proxyPrim)
+  {
+    std::vector<const PrimitiveGeometry*> parts;
+    for (int primitiveIndex : primitiveIndices)
+    {
+      std::optional<PrimitiveGeometry>& geometry = geometries[primitiveIndex];
+
+      // Geometry is consumed on creation and needs to be decoded again if creation failed before
+      if (!geometry.has_value())
       {
-        detail::markAttributeAsGenerated(primvar);
+        PrimitiveGeometry decodedGeometry;
+        if (!acquirePrimitiveGeometry(&meshData->primitives[primitiveIndex], decodedGeometry))
+        {
+          return false;
+        }
+        geometry = std::move(decodedGeometry);
       }
+
+      parts.push_back(&geometry.value());
+    }
+
+    PrimitiveGeometry geometry;
+    mergePrimitiveGeometries(parts, geometry);
+
+    // Double-sidedness, the only mesh-level material property, is equal for all parts
+    const cgltf_primitive* firstPrimitiveData = &meshData->primitives[primitiveIndices[0]];
+    const cgltf_material* material = firstPrimitiveData->material ? firstPrimitiveData->material : &DEFAULT_MATERIAL;
+
+    createMesh(geometry, material, path, prim);
+    if (!prim)
+    {
+      return false;
     }
-    if (!displayOpacities.empty())
+
+    createMaterialBindSubsets(prim, primitiveIndices, parts);
+
+    if (m_params.proxyRatio <= 0.0f || !detail::hasTriangleTopology(firstPrimitiveData))
     {
-      auto primvar = mesh.CreateDisplayOpacityPrimvar(displayPrimvarInterpolation);
-      primvar.Set(displayOpacities);
+      return true;
+    }
 
-      if (generatedDisplayColors)
+    // Parts are simplified individually to keep the subset boundaries
+    std::vector<PrimitiveGeometry> proxyParts(parts.size());
+    std::vector<const PrimitiveGeometry*> proxyPartPtrs;
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+      if (!createProxyGeometry(*parts[i], proxyParts[i]))
       {
-        detail::markAttributeAsGenerated(primvar);
+        return true;
       }
+      proxyPartPtrs.push_back(&proxyParts[i]);
     }
 
-    prim = mesh.GetPrim();
+    PrimitiveGeometry proxyGeometry;
+    mergePrimitiveGeometries(proxyPartPtrs, proxyGeometry);
+
+    auto proxyPath = m_pathRegistry.makeUniqueSubpath(path.GetParentPath(), path.GetName() + "_proxy");
+    createMesh(proxyGeometry, material, proxyPath, proxyPrim);
+    if (!proxyPrim)
+    {
+      return true;
+    }
+
+    createMaterialBindSubsets(proxyPrim, primitiveIndices, proxyPartPtrs);
+
+    UsdGeomImageable(prim).CreatePurposeAttr(VtValue(UsdGeomTokens->render));
+    UsdGeomImageable(proxyPrim).CreatePurposeAttr(VtValue(UsdGeomTokens->proxy));
+
+    m_proxyPaths[firstPrimitiveData] = proxyPath;
     return true;
   }
 
+  void Converter::createMaterialBindSubsets(UsdPrim& prim,
+                                            const std::vector<int>& primitiveIndices,
+                                            const std::vector<const PrimitiveGeometry*>& parts)
+  {
+    if (parts.size() < 2)
+    {
+      return;
+    }
+
+    UsdShadeMaterialBindingAPI bindingAPI(prim);
+
+    int faceOffset = 0;
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+      int faceCount = int(parts[i]->faceVertexCounts.size());
+
+      VtIntArray faceIndices(faceCount);
+      for (int j = 0; j < faceCount; j++)
+      {
+        faceIndices[j] = faceOffset + j;
+      }
+
+      TfToken subsetName(makePrimitiveSubsetName(primitiveIndices[i]));
+      bindingAPI.CreateMaterialBindSubset(subsetName, faceIndices, UsdGeomTokens->face);
+
+      faceOffset += faceCount;
+    }
+
+    // Each face belongs to exactly one primitive
+    bindingAPI.SetMaterialBindSubsetsFamilyType(UsdGeomTokens->partition);
+  }
+
+  void Converter::createMesh(const PrimitiveGeometry& geometry, const cgltf_material* material, const SdfPath& path, UsdPrim& prim)
+  {
+    const VtIntArray& indices = geometry.indices;
+    const VtVec3fArray& points = geometry.points;
+    const VtVec3fArray& normals = geometry.normals;
+    bool generatedNormals = geometry.generatedNormals;
+    bool generatedTangents = geometry.generatedTangents;
+    bool generatedDisplayColors = geometry.generatedDisplayColors;
+
+    // Create GPrim and assign values. Each Usd API call would be processed as a separate
+    // change, so we author the specs directly and let the stage recompose once.
+    {
+      SdfChangeBlock changeBlock;
+
+      detail::PrimSpecWriter mesh(m_stage, path, _tokens->Mesh);
+      if (!mesh)
+      {
+        TF_RUNTIME_ERROR("unable to create mesh prim at %s", path.GetText());
+        return;
+      }
+
+      mesh.createAttribute(UsdGeomTokens->subdivisionScheme, SdfValueTypeNames->Token, VtValue(UsdGeomTokens->none), SdfVariabilityUniform);
+
+      if (material->double_sided)
+      {
+        mesh.createAttribute(UsdGeomTokens->doubleSided, SdfValueTypeNames->Bool, VtValue(true), SdfVariabilityUniform);
+      }
+
+      if (!indices.empty())
+      {
+        auto attr = mesh.createAttribute(UsdGeomTokens->faceVertexIndices, SdfValueTypeNames->IntArray, VtValue(indices));
+
+        // If we generated normals or tangents, we have re-indexed the mesh. This means
+        // that we have de-indexed all other primvars; but unlike the indices, their data
+        // still exists and is just encoded in a different way. This is why we only add
+        // the "generated" custom data to the indices.
+        if ((generatedNormals && geometry.normalIndices.empty()) ||
+            (generatedTangents && geometry.tangentIndices.empty()))
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+      mesh.createAttribute(UsdGeomTokens->points, SdfValueTypeNames->Point3fArray, VtValue(points));
+      mesh.createAttribute(UsdGeomTokens->faceVertexCounts, SdfValueTypeNames->IntArray, VtValue(geometry.faceVertexCounts));
+
+      if (!geometry.normalIndices.empty())
+      {
+        // The normals attribute can not be indexed, but the equivalent primvar can
+        auto attr = mesh.createPrimvar(UsdGeomTokens->normals, SdfValueTypeNames->Normal3fArray, UsdGeomTokens->faceVarying,
+                                       VtValue(normals), geometry.normalIndices);
+
+        if (generatedNormals)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+      else if (!normals.empty())
+      {
+        auto attr = mesh.createAttribute(UsdGeomTokens->normals, SdfValueTypeNames->Normal3fArray, VtValue(normals));
+        attr->SetInfo(UsdGeomTokens->interpolation, VtValue(UsdGeomTokens->vertex));
+
+        if (generatedNormals)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+
+      VtVec3fArray extent;
+      if (UsdGeomPointBased::ComputeExtent(points, &extent))
+      {
+        mesh.createAttribute(UsdGeomTokens->extent, SdfValueTypeNames->Float3Array, VtValue(extent));
+      }
+      else
+      {
+        TF_WARN("unable to compute extent for mesh");
+      }
+
+      // There is no formal schema for tangents and tangent signs/bitangents, so we define our own primvars
+      const VtIntArray& tangentIndices = geometry.tangentIndices;
+      TfToken tangentInterpolation = tangentIndices.empty() ? UsdGeomTokens->vertex : UsdGeomTokens->faceVarying;
+      if (!geometry.tangents.empty())
+      {
+        const SdfValueTypeName& typeName = geometry.halfTangents ? SdfValueTypeNames->Half3Array : SdfValueTypeNames->Float3Array;
+        auto attr = mesh.createPrimvar(UsdGeomTokens->tangents, typeName, tangentInterpolation,
+                                       detail::makePrimvarValue<GfVec3h>(geometry.tangents, geometry.halfTangents), tangentIndices);
+
+        if (generatedTangents)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+      if (!geometry.bitangentSigns.empty())
+      {
+        const SdfValueTypeName& typeName = geometry.halfTangents ? SdfValueTypeNames->HalfArray : SdfValueTypeNames->FloatArray;
+        auto attr = mesh.createPrimvar(_tokens->bitangentSigns, typeName, tangentInterpolation,
+                                       detail::makePrimvarValue<GfHalf>(geometry.bitangentSigns, geometry.halfTangents), tangentIndices);
+
+        if (generatedTangents)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+
+      for (size_t i = 0; i < geometry.texCoordSets.size(); i++)
+      {
+        const VtVec2fArray& texCoords = geometry.texCoordSets[i];
+        if (texCoords.empty())
+        {
+          continue;
+        }
+        bool half = geometry.halfTexCoordSets[i];
+        auto primvarId = TfToken(makeStSetName(i));
+        const SdfValueTypeName& typeName = half ? SdfValueTypeNames->TexCoord2hArray : SdfValueTypeNames->TexCoord2fArray;
+        mesh.createPrimvar(primvarId, typeName, UsdGeomTokens->vertex, detail::makePrimvarValue<GfVec2h>(texCoords, half));
+      }
+
+      for (size_t i = 0; i < geometry.colorSets.size(); i++)
+      {
+        const VtVec3fArray& colors = geometry.colorSets[i];
+        if (colors.empty())
+        {
+          continue;
+        }
+        bool half = geometry.halfColorSets[i];
+        auto colorPrimvarId = TfToken(makeColorSetName(i));
+        const SdfValueTypeName& colorTypeName = half ? SdfValueTypeNames->Half3Array : SdfValueTypeNames->Float3Array;
+        mesh.createPrimvar(colorPrimvarId, colorTypeName, UsdGeomTokens->vertex, detail::makePrimvarValue<GfVec3h>(colors, half));
+
+        // We do an emptyness check here instead of in the retrieval routine above
+        // in order to keep the color-opacity primvar index correspondence, e.g.:
+        //  color1, opacity1
+        //  color2, (missing)
+        //  color3, opacity3
+        const VtFloatArray& opacities = geometry.opacitySets[i];
+        if (opacities.empty())
+        {
+          continue;
+        }
+        auto opacityPrimvarId = TfToken(makeOpacitySetName(i));
+        const SdfValueTypeName& opacityTypeName = half ? SdfValueTypeNames->HalfArray : SdfValueTypeNames->FloatArray;
+        mesh.createPrimvar(opacityPrimvarId, opacityTypeName, UsdGeomTokens->vertex, detail::makePrimvarValue<GfHalf>(opacities, half));
+      }
+
+      TfToken displayPrimvarInterpolation = generatedDisplayColors ? UsdGeomTokens->constant : UsdGeomTokens->vertex;
+      if (!geometry.displayColors.empty())
+      {
+        auto attr = mesh.createPrimvar(_tokens->displayColor, SdfValueTypeNames->Color3fArray,
+                                       displayPrimvarInterpolation, VtValue(geometry.displayColors));
+
+        if (generatedDisplayColors)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+      if (!geometry.displayOpacities.empty())
+      {
+        auto attr = mesh.createPrimvar(_tokens->displayOpacity, SdfValueTypeNames->FloatArray,
+                                       displayPrimvarInterpolation, VtValue(geometry.displayOpacities));
+
+        if (generatedDisplayColors)
+        {
+          detail::markAttributeAsGenerated(attr);
+        }
+      }
+    }
+
+    prim = m_stage->GetPrimAtPath(path);
+  }
+
   bool Converter::overridePrimInPathMap(void* dataPtr, const SdfPath& path, UsdPrim& prim)
   {
     auto iter = m_uniquePaths.find((void*) dataPtr);
@@ -1239,7 +2587,97 @@ namespace guc
     return true;
   }
 
-  bool Converter::isValidTexture(const cgltf_texture_view& textureView)
+  bool Converter::useHalfPrecision(const cgltf_accessor* accessor) const
+  {
+    switch (m_params.primvarPrecision)
+    {
+    case PrimvarPrecision::Half:
+      return true;
+    case PrimvarPrecision::Auto:
+      // Quantized data signals that the asset does not rely on full float precision
+      return accessor->component_type != cgltf_component_type_r_32f && accessor->normalized;
+    default:
+      return false;
+    }
+  }
+
+  template<typename T>
+  bool Converter::readCachedVtArray(const cgltf_accessor* accessor, VtArray<T>& array, AccessorTransform transform) const
+  {
+    auto key = std::make_pair(accessor, transform);
+    int remainingUses = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_accessorCacheMutex);
+
+      auto useCountIter = m_accessorUseCounts.find(accessor);
+      if (useCountIter != m_accessorUseCounts.end() && useCountIter->second > 0)
+      {
+        remainingUses = --useCountIter->second;
+      }
+
+      bool cached = false;
+      auto iter = m_accessorCache.find(key);
+      if (iter != m_accessorCache.end() && iter->second.IsHolding<VtArray<T>>())
+      {
+        array = iter->second.UncheckedGet<VtArray<T>>();
+        cached = true;
+      }
+
+      // Release the decoded arrays after the last use, so that they don't outlive the copies
+      // that are de-indexed or otherwise modified
+      if (remainingUses == 0)
+      {
+        m_accessorCache.erase(std::make_pair(accessor, AccessorTransform::None));
+        m_accessorCache.erase(std::make_pair(accessor, AccessorTransform::FlipTexCoordsY));
+      }
+
+      if (cached)
+      {
+        return true;
+      }
+    }
+
+    // Decode without holding the lock; concurrent decodes of the same accessor are redundant but harmless
+    if (!detail::readVtArrayFromAccessor(m_data, accessor, array))
+    {
+      return false;
+    }
+
+    if (transform == AccessorTransform::FlipTexCoordsY)
+    {
+      if constexpr (std::is_same<T, GfVec2f>())
+      {
+        flipTexCoordsY(array);
+      }
+      else
+      {
+        TF_CODING_ERROR("texcoord transform applied to non-texcoord accessor");
+        return false;
+      }
+    }
+
+    if (remainingUses == 0)
+    {
+      return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_accessorCacheMutex);
+
+    // The other uses may have been decoded concurrently in the meantime
+    if (m_accessorUseCounts[accessor] == 0)
+    {
+      return true;
+    }
+
+    auto [iter, inserted] = m_accessorCache.try_emplace(key, VtValue(array));
+    if (!inserted && iter->second.IsHolding<VtArray<T>>())
+    {
+      array = iter->second.UncheckedGet<VtArray<T>>(); // share the first decoded copy
+    }
+    return true;
+  }
+
+  bool Converter::isValidTexture(const cgltf_texture_view& textureView) const
   {
     const cgltf_texture* texture = textureView.texture;
     if (!texture)
@@ -17,16 +17,27 @@
 #pragma once
 
 #include <cgltf.h>
+#include <pxr/base/gf/matrix4d.h>
+#include <pxr/base/vt/types.h>
+#include <pxr/base/vt/value.h>
 #include <pxr/usd/usd/prim.h>
+#include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usdShade/shader.h>
 #include <MaterialXCore/Document.h>
 
 #include <unordered_map>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
+#include <vector>
 
+#include "image.h"
 #include "materialx.h"
+#include "naming.h"
 #include "usdpreviewsurface.h"
 
 namespace fs = std::filesystem;
@@ -34,6 +45,22 @@ using namespace PXR_NS;
 
 namespace guc
 {
+  struct VertexStream;
+
+  enum class PrimvarPrecision
+  {
+    Float,
+    Auto, // Half precision for attributes that are quantized in the glTF file
+    Half
+  };
+
+  enum class TransformMode
+  {
+    Preserve,
+    Collapse, // Fold transform-only nodes with a single child into the child
+    Flatten // Fold all transform-only nodes into their children
+  };
+
   class Converter
   {
   public:
@@ -43,10 +70,22 @@ namespace guc
       fs::path dstDir;
       fs::path mtlxFileName;
       bool copyExistingFiles;
+      ImageCopyMode imageCopyMode;
       bool genRelativePaths;
       bool emitMtlx;
       bool mtlxAsUsdShade;
       int defaultMaterialVariant;
+      bool multithreaded;
+      bool keepFilesInMemory; // Don't write images and MaterialX files, but return their contents
+      bool instancing;
+      bool optimizeMeshes;
+      bool faceVaryingPrimvars;
+      float proxyRatio; // Triangle ratio of proxy meshes; 0 disables proxy generation
+      PrimvarPrecision primvarPrecision;
+      bool mergePrimitives;
+      TransformMode transformMode;
+      std::string imageFileNamePrefix;
+      SharedPathRegistry* sharedImagePaths; // Optional, for conversions writing to the same directory
     };
 
   public:
@@ -57,23 +96,128 @@ namespace guc
     {
       std::string filePath;
       std::string refPath;
+      // Set if the file has not been written but kept in memory
+      std::shared_ptr<const char> data;
+      size_t dataSize = 0;
+      // Set if a prim references the file, but the reference has not been authored yet
+      SdfPath referencingPrimPath;
+      SdfPath referencedPrimPath;
     };
     using FileExports = std::vector<FileExport>;
 
     void convert(FileExports& fileExports);
 
+    // A stage can't compose references to files that are kept in memory. They are authored
+    // on the root layer by this function instead, once the stage has been released.
+    static void authorDeferredReferences(const FileExports& fileExports, const SdfLayerHandle& layer);
+
+  private:
+    // Transformation applied to accessor data, part of the decode cache key
+    enum class AccessorTransform
+    {
+      None,
+      FlipTexCoordsY
+    };
+
+    struct XformOp
+    {
+      TfToken name;
+      SdfValueTypeName typeName;
+      VtValue value;
+    };
+
+    // A node of the scene graph with its unique prim paths, planned before authoring
+    struct NodePlan
+    {
+      const cgltf_node* nodeData;
+      SdfPath path;
+      SdfPath meshPath; // empty if none
+      SdfPath cameraPath; // empty if none
+      SdfPath lightPath; // empty if none
+      std::string meshName;
+      std::string cameraName;
+      std::string lightName;
+      const char* displayName; // may be inherited from a folded ancestor
+      std::optional<GfMatrix4d> collapsedTransform; // composed with folded ancestors
+    };
+
+    // Vertex data and topology of a glTF primitive, ready to be authored
+    struct PrimitiveGeometry
+    {
+      VtIntArray indices;
+      VtIntArray faceVertexCounts;
+      VtVec3fArray points;
+      VtVec3fArray normals;
+      VtVec3fArray tangents;
+      VtFloatArray bitangentSigns;
+      VtIntArray normalIndices; // face-varying if not empty
+      VtIntArray tangentIndices; // face-varying if not empty
+      std::vector<VtVec2fArray> texCoordSets;
+      std::vector<VtVec3fArray> colorSets;
+      std::vector<VtFloatArray> opacitySets;
+      VtVec3fArray displayColors;
+      VtFloatArray displayOpacities;
+      // Whether primvars are authored with half precision
+      std::vector<bool> halfTexCoordSets;
+      std::vector<bool> halfColorSets; // includes opacities
+      bool halfTangents = false;
+      bool generatedNormals = false;
+      bool generatedTangents = false;
+      bool generatedDisplayColors = false;
+    };
+
   private:
     void createMaterials(FileExports& fileExports, bool createDefaultMaterial);
-    void createNodesRecursively(const cgltf_node* nodeData, SdfPath path);
+    void planNodes(const cgltf_node* rootNodeData, const SdfPath& parentPath, std::vector<NodePlan>& plans);
+    void createNodes(const std::vector<NodePlan>& plans);
+    static void createXformOps(const cgltf_node* nodeData, std::vector<XformOp>& xformOps);
     void createOrOverCamera(const cgltf_camera* cameraData, SdfPath path);
     void createOrOverLight(const cgltf_light* lightData, SdfPath path);
     void createOrOverMesh(const cgltf_mesh* meshData, SdfPath path);
+    void createMergedPrimitives(const cgltf_mesh* meshData, const SdfPath& path);
+    void createPrimitiveMaterialBindings(const cgltf_primitive* primitiveData, UsdPrim& prim, UsdPrim& proxyPrim);
+    void createPointInstancer(const cgltf_node* nodeData, SdfPath path, const std::string& meshName);
     void createMaterialBinding(UsdPrim& prim, const std::string& materialName);
-    bool createPrimitive(const cgltf_primitive* primitiveData, SdfPath path, UsdPrim& prim);
+    void countInstanceUses(const cgltf_node* rootNodeData);
+    void countAccessorUses();
+    template<typename T>
+    void createOrInstance(const T* data,
+                          const SdfPath& path,
+                          EntryPathType prototypeType,
+                          const std::string& name,
+                          void (Converter::*createOrOverFunc)(const T*, SdfPath));
+    void decodePrimitives();
+    bool decodePrimitive(const cgltf_primitive* primitiveData, PrimitiveGeometry& geometry) const;
+    void optimizePrimitive(PrimitiveGeometry& geometry) const;
+    static void getVertexStreams(const PrimitiveGeometry& geometry, std::vector<VertexStream>& streams);
+    static void remapPrimitiveVertices(PrimitiveGeometry& geometry, const std::vector<unsigned int>& remap, size_t newVertexCount);
+    bool createProxyGeometry(const PrimitiveGeometry& geometry, PrimitiveGeometry& proxyGeometry) const;
+    bool acquirePrimitiveGeometry(const cgltf_primitive* primitiveData, PrimitiveGeometry& geometry);
+    bool createPrimitive(const cgltf_primitive* primitiveData, SdfPath path, UsdPrim& prim, UsdPrim& proxyPrim);
+    bool canMergePrimitives(const cgltf_primitive* primitiveDataA,
+                            const PrimitiveGeometry& geometryA,
+                            const cgltf_primitive* primitiveDataB,
+                            const PrimitiveGeometry& geometryB) const;
+    static void mergePrimitiveGeometries(const std::vector<const PrimitiveGeometry*>& parts, PrimitiveGeometry& merged);
+    bool createMergedPrimitive(const cgltf_mesh* meshData,
+                               const std::vector<int>& primitiveIndices,
+                               std::vector<std::optional<PrimitiveGeometry>>& geometries,
+                               const SdfPath& path,
+                               UsdPrim& prim,
+                               UsdPrim& proxyPrim);
+    void createMaterialBindSubsets(UsdPrim& prim,
+                                   const std::vector<int>& primitiveIndices,
+                                   const std::vector<const PrimitiveGeometry*>& parts);
+    void createMesh(const PrimitiveGeometry& geometry, const cgltf_material* material, const SdfPath& path, UsdPrim& prim);
 
   private:
     bool overridePrimInPathMap(void* dataPtr, const SdfPath& path, UsdPrim& prim);
-    bool isValidTexture(const cgltf_texture_view& textureView);
+    bool isValidTexture(const cgltf_texture_view& textureView) const;
+    bool useHalfPrecision(const cgltf_accessor* accessor) const;
+    template<typename T>
+    bool readCachedVtArray(const cgltf_accessor* accessor,
+                           VtArray<T>& array,
+                           AccessorTransform transform = AccessorTransform::None) const;
 
   private:
     const cgltf_data* m_data;
@@ -84,8 +228,19 @@ namespace guc
     ImageMetadataMap m_imgMetadata;
     MaterialX::DocumentPtr m_mtlxDoc;
     MaterialXMaterialConverter m_mtlxConverter;
+    UniquePathRegistry m_pathRegistry;
     UsdPreviewSurfaceMaterialConverter m_usdPreviewSurfaceConverter;
     std::unordered_map<void*, SdfPath> m_uniquePaths;
+    std::unordered_map<const void*, int> m_instanceUseCounts;
+    std::unordered_map<const void*, SdfPath> m_prototypePaths;
     std::vector<std::string> m_materialNames;
+    std::unordered_map<const cgltf_primitive*, std::optional<PrimitiveGeometry>> m_decodedPrimitives;
+    std::unordered_map<const cgltf_primitive*, SdfPath> m_proxyPaths;
+    std::unordered_map<const cgltf_mesh*, std::vector<std::vector<int>>> m_mergedPrimitiveIndices;
+    // Accessors are often shared between primitives. Decoded arrays of accessors with more
+    // than one use are shared copy-on-write, and released after their last use.
+    mutable std::mutex m_accessorCacheMutex;
+    mutable std::unordered_map<const cgltf_accessor*, int> m_accessorUseCounts; // remaining uses
+    mutable std::map<std::pair<const cgltf_accessor*, AccessorTransform>, VtValue> m_accessorCache;
   };
 }
@@ -128,7 +128,7 @@ bool UsdGlTFFileFormat::Read(SdfLayer* layer,
   ArResolverContextBinder binder(ctx);
 
   cgltf_data* gltf_data = nullptr;
-  if (!load_gltf(resolvedPath.c_str(), &gltf_data))
+  if (!load_gltf(resolvedPath.c_str(), &gltf_data, /* multithreaded */ true))
   {
     TF_RUNTIME_ERROR("unable to load glTF file %s", resolvedPath.c_str());
     return false;
@@ -142,10 +142,21 @@ bool UsdGlTFFileFormat::Read(SdfLayer* layer,
   params.dstDir = s_tmpDirHolder.makeDir();
   params.mtlxFileName = ""; // Not needed because of Mtlx-as-UsdShade option
   params.copyExistingFiles = false;
+  params.imageCopyMode = ImageCopyMode::Write;
   params.genRelativePaths = false;
   params.emitMtlx = data->emitMtlx;
   params.mtlxAsUsdShade = true;
   params.defaultMaterialVariant = 0;
+  params.multithreaded = true;
+  params.keepFilesInMemory = false;
+  params.instancing = false;
+  params.optimizeMeshes = false;
+  params.faceVaryingPrimvars = false;
+  params.proxyRatio = 0.0f;
+  params.primvarPrecision = PrimvarPrecision::Float;
+  params.mergePrimitives = false;
+  params.transformMode = TransformMode::Preserve;
+  params.sharedImagePaths = nullptr;
 
   SdfLayerRefPtr tmpLayer = SdfLayer::CreateAnonymous(".usdc");
   UsdStageRefPtr stage = UsdStage::Open(tmpLayer);
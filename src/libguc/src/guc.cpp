@@ -17,18 +17,21 @@
 #include "guc.h"
 
 #include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/work/dispatcher.h>
 #include <pxr/usd/ar/defaultResolverContext.h>
 #include <pxr/usd/ar/resolverContext.h>
 #include <pxr/usd/ar/resolverContextBinder.h>
+#include <pxr/usd/sdf/layer.h>
 #include <pxr/usd/usd/stage.h>
-#include <pxr/usd/usd/zipFile.h>
 #include <pxr/usd/usdUtils/dependencies.h>
 
 #include <filesystem>
+#include <system_error>
 
 #include "debugCodes.h"
 #include "cgltf_util.h"
 #include "converter.h"
+#include "usdz.h"
 
 using namespace guc;
 namespace fs = std::filesystem;
@@ -36,8 +39,12 @@ namespace fs = std::filesystem;
 bool convertToUsd(fs::path src_dir,
                   const cgltf_data* gltf_data,
                   fs::path usd_path,
+                  fs::path mtlx_file_name,
                   bool copyExistingFiles,
+                  bool keepFilesInMemory,
                   const guc_options* options,
+                  const std::string& imageFileNamePrefix,
+                  SharedPathRegistry* sharedImagePaths,
                   Converter::FileExports& fileExports)
 {
   UsdStageRefPtr stage = UsdStage::CreateNew(usd_path.string());
@@ -50,26 +57,107 @@ bool convertToUsd(fs::path src_dir,
   Converter::Params params = {};
   params.srcDir = src_dir;
   params.dstDir = usd_path.parent_path();
-  params.mtlxFileName = usd_path.filename().replace_extension(".mtlx");
+  params.mtlxFileName = mtlx_file_name;
   params.copyExistingFiles = copyExistingFiles;
+  params.imageCopyMode = ImageCopyMode::Write;
+  if (options->image_copy_mode >= GUC_IMAGE_COPY_MODE_WRITE &&
+      options->image_copy_mode <= GUC_IMAGE_COPY_MODE_HARDLINK)
+  {
+    params.imageCopyMode = ImageCopyMode(options->image_copy_mode);
+  }
+  else
+  {
+    TF_RUNTIME_ERROR("invalid image copy mode %d; writing images instead", int(options->image_copy_mode));
+  }
   params.genRelativePaths = true;
   params.emitMtlx = options->emit_mtlx;
   params.mtlxAsUsdShade = options->mtlx_as_usdshade;
   params.defaultMaterialVariant = options->default_material_variant;
+  params.multithreaded = options->multithreaded;
+  params.keepFilesInMemory = keepFilesInMemory;
+  params.instancing = options->instancing;
+  params.optimizeMeshes = options->optimize_meshes;
+  params.faceVaryingPrimvars = options->face_varying_primvars;
+  params.proxyRatio = options->proxy_ratio;
+  params.primvarPrecision = PrimvarPrecision::Float;
+  if (options->primvar_precision >= GUC_PRIMVAR_PRECISION_FLOAT &&
+      options->primvar_precision <= GUC_PRIMVAR_PRECISION_HALF)
+  {
+    params.primvarPrecision = PrimvarPrecision(options->primvar_precision);
+  }
+  else
+  {
+    TF_RUNTIME_ERROR("invalid primvar precision %d; using float precision instead", int(options->primvar_precision));
+  }
+  params.mergePrimitives = options->merge_primitives;
+  params.transformMode = TransformMode::Preserve;
+  if (options->transform_mode >= GUC_TRANSFORM_MODE_PRESERVE &&
+      options->transform_mode <= GUC_TRANSFORM_MODE_FLATTEN)
+  {
+    params.transformMode = TransformMode(options->transform_mode);
+  }
+  else
+  {
+    TF_RUNTIME_ERROR("invalid transform mode %d; preserving transforms instead", int(options->transform_mode));
+  }
+  params.imageFileNamePrefix = imageFileNamePrefix;
+  params.sharedImagePaths = sharedImagePaths;
+
+  {
+    Converter converter(gltf_data, stage, params);
+
+    converter.convert(fileExports);
+  }
 
-  Converter converter(gltf_data, stage, params);
+  // References to files kept in memory can't be resolved, so they are only authored once
+  // no stage composes the layer anymore
+  SdfLayerRefPtr layer = stage->GetRootLayer();
+  stage.Reset();
 
-  converter.convert(fileExports);
+  Converter::authorDeferredReferences(fileExports, layer);
 
-  TF_DEBUG(GUC).Msg("saving stage to %s\n", usd_path.string().c_str());
-  stage->Save();
+  TF_DEBUG(GUC).Msg("saving layer to %s\n", usd_path.string().c_str());
+  layer->Save();
 
   return true;
 }
 
-bool guc_convert(const char* gltf_path,
-                 const char* usd_path,
-                 const guc_options* options)
+bool writeUsdz(const fs::path& usdz_path,
+               const fs::path& usdc_path,
+               const std::string& usdc_path_in_usdz,
+               const Converter::FileExports& fileExports)
+{
+  TF_DEBUG(GUC).Msg("creating USDZ archive %s\n", usdz_path.string().c_str());
+  UsdzWriter writer;
+  if (!writer.open(usdz_path.string().c_str()))
+  {
+    return false;
+  }
+
+  // The USDZ specification requires the root layer to be the first file
+  if (!writer.addFileFromPath(usdc_path_in_usdz, usdc_path.string().c_str()))
+  {
+    return false; // Fatal error
+  }
+
+  for (const auto& fileExport : fileExports)
+  {
+    if (!fileExport.data)
+    {
+      TF_RUNTIME_ERROR("unable to add %s to USDZ archive: no data", fileExport.refPath.c_str());
+      continue; // (non-fatal error)
+    }
+
+    writer.addFile(fileExport.refPath, fileExport.data.get(), fileExport.dataSize); // (non-fatal error)
+  }
+
+  return writer.close();
+}
+
+bool convertAsset(const char* gltf_path,
+                  const char* usd_path,
+                  const guc_options* options,
+                  SharedPathRegistry* sharedImagePaths)
 {
   fs::path src_dir = fs::path(gltf_path).parent_path();
 
@@ -78,94 +166,115 @@ bool guc_convert(const char* gltf_path,
   ArDefaultResolverContext ctx({src_dir.string()});
   ArResolverContextBinder binder(ctx);
 
-  // The path we write USDA/USDC files to. If the user wants a USDZ file, we first
-  // write these files to a temporary location, zip them, and copy the ZIP file to
-  // the destination directory.
+  // The path we write USDA/USDC files to. If the user wants a USDZ file, images and
+  // MaterialX documents are kept in memory and streamed into the archive. Only the USDC
+  // layer is written to a temporary directory next to the destination, because USD
+  // can not serialize binary layers to memory.
   fs::path final_usd_path = usd_path;
   fs::path base_usd_path = usd_path;
-  fs::path dst_dir = base_usd_path.parent_path();
 
   bool export_usdz = base_usd_path.extension() == ".usdz";
 
+  fs::path mtlx_file_name = fs::path(final_usd_path.filename()).replace_extension(".mtlx");
+  std::string usdc_path_in_usdz;
+  std::string tmp_dir_path;
+
   if (export_usdz)
   {
-    dst_dir = ArchMakeTmpSubdir(ArchGetTmpDir(), "guc");
-    TF_DEBUG(GUC).Msg("using temp dir %s\n", dst_dir.string().c_str());
+    auto usdz_dst_dir = fs::absolute(final_usd_path).parent_path();
+    if (!fs::exists(usdz_dst_dir) && !fs::create_directories(usdz_dst_dir))
+    {
+      TF_RUNTIME_ERROR("unable to create destination directory");
+      return false;
+    }
 
-    if (dst_dir.empty())
+    tmp_dir_path = ArchMakeTmpSubdir(usdz_dst_dir.string(), "." + final_usd_path.stem().string());
+    if (tmp_dir_path.empty())
     {
       TF_RUNTIME_ERROR("unable to create temporary directory for USDZ contents");
       return false;
     }
 
-    auto new_usd_filename = base_usd_path.replace_extension(".usdc").filename();
-    base_usd_path = dst_dir / new_usd_filename;
+    usdc_path_in_usdz = fs::path(final_usd_path.filename()).replace_extension(".usdc").string();
+    base_usd_path = fs::path(tmp_dir_path) / usdc_path_in_usdz;
     TF_DEBUG(GUC).Msg("temporary USD path: %s\n", base_usd_path.string().c_str());
   }
 
   cgltf_data* gltf_data = nullptr;
-  if (!load_gltf(gltf_path, &gltf_data))
+  if (!load_gltf(gltf_path, &gltf_data, options->multithreaded))
   {
     TF_RUNTIME_ERROR("unable to load glTF file %s", gltf_path);
+    if (export_usdz)
+    {
+      std::error_code errorCode;
+      fs::remove_all(tmp_dir_path, errorCode);
+    }
     return false;
   }
 
-  bool copyExistingFiles = !export_usdz; // Add source files directly to archive in case of USDZ
+  // In case of USDZ, all referenced files are written to the archive from memory
+  bool copyExistingFiles = true;
+  bool keepFilesInMemory = export_usdz;
 
   Converter::FileExports fileExports;
-  bool result = convertToUsd(src_dir, gltf_data, base_usd_path, copyExistingFiles, options, fileExports);
+  // Assets of a batch may share their destination directory, so image names are prefixed
+  std::string imageFileNamePrefix = sharedImagePaths ? (final_usd_path.stem().string() + "_") : "";
 
-  free_gltf(gltf_data);
-
-  if (!result)
-  {
-    return false;
-  }
+  bool result = convertToUsd(src_dir, gltf_data, base_usd_path, mtlx_file_name, copyExistingFiles,
+                             keepFilesInMemory, options, imageFileNamePrefix, sharedImagePaths, fileExports);
 
-  // In case of USDZ, we have now written the USDC file and all image files to a
-  // temporary directory. Next, we invoke Pixar's USDZ API in order to zip them.
+  // Image data is shared with the glTF buffers, so we can only free them once the archive is written
   if (export_usdz)
   {
-    auto usdz_dst_dir = fs::absolute(final_usd_path).parent_path();
-    if (!fs::exists(usdz_dst_dir) && !fs::create_directories(usdz_dst_dir))
+    if (result)
     {
-      TF_RUNTIME_ERROR("unable to create destination directory");
-      return false;
+      result = writeUsdz(final_usd_path, base_usd_path, usdc_path_in_usdz, fileExports);
     }
 
-    TF_DEBUG(GUC).Msg("creating USDZ archive %s\n", final_usd_path.string().c_str());
-    UsdZipFileWriter writer = UsdZipFileWriter::CreateNew(final_usd_path.string());
+    TF_DEBUG(GUC).Msg("removing temporary directory %s\n", tmp_dir_path.c_str());
+    std::error_code errorCode;
+    fs::remove_all(tmp_dir_path, errorCode);
+  }
 
-    TF_DEBUG(GUC).Msg("adding %s to USDZ archive at ./%s\n", base_usd_path.string().c_str(), base_usd_path.filename().string().c_str());
-    if (writer.AddFile(base_usd_path.string(), base_usd_path.filename().string()) == "")
-    {
-      TF_RUNTIME_ERROR("unable to usdzip %s to %s", base_usd_path.string().c_str(), base_usd_path.filename().string().c_str());
-      return false; // Fatal error
-    }
-    for (const auto& fileExport : fileExports)
-    {
-      // We need to pass explicit source paths to UsdZipFileWriter because it uses the lower-level file
-      // API instead of USD's ArResolver: https://github.com/PixarAnimationStudios/OpenUSD/issues/2374
-      std::string srcPath = (src_dir / fileExport.filePath).string();
-      std::string dstPathInUsdz = fileExport.refPath;
-
-      TF_DEBUG(GUC).Msg("adding %s to USDZ archive at ./%s\n", srcPath.c_str(), dstPathInUsdz.c_str());
-      if (writer.AddFile(srcPath, dstPathInUsdz) == "")
-      {
-        TF_RUNTIME_ERROR("unable to usdzip %s to %s", srcPath.c_str(), dstPathInUsdz.c_str());
-        // (non-fatal error)
-      }
-    }
+  fileExports.clear();
+  free_gltf(gltf_data);
 
-    if (!writer.Save())
-    {
-      TF_RUNTIME_ERROR("unable to save USDZ file");
-      return false;
-    }
+  return result;
+}
+
+bool guc_convert(const char* gltf_path,
+                 const char* usd_path,
+                 const guc_options* options)
+{
+  return convertAsset(gltf_path, usd_path, options, nullptr);
+}
 
-    TF_DEBUG(GUC).Msg("removing temporary directory %s\n", dst_dir.string().c_str());
-    fs::remove_all(dst_dir);
+bool guc_convert_batch(struct guc_batch_item* items,
+                       size_t item_count,
+                       const struct guc_options* options)
+{
+  WorkDispatcher dispatcher;
+
+  // Items may be written to the same directory, so no two of them may write the same image file
+  SharedPathRegistry sharedImagePaths;
+
+  for (size_t i = 0; i < item_count; i++)
+  {
+    guc_batch_item* item = &items[i];
+
+    dispatcher.Run([item, options, &sharedImagePaths]() {
+      TF_DEBUG(GUC).Msg("converting %s to %s\n", item->gltf_path, item->usd_path);
+      item->succeeded = convertAsset(item->gltf_path, item->usd_path, options, &sharedImagePaths);
+    });
   }
 
-  return true;
+  // Errors of all conversions are posted to this thread
+  dispatcher.Wait();
+
+  bool result = true;
+  for (size_t i = 0; i < item_count; i++)
+  {
+    result &= items[i].succeeded;
+  }
+  return result;
 }
@@ -16,11 +16,16 @@
 
 #include "image.h"
 
+#include <pxr/base/arch/defines.h>
 #include <pxr/base/arch/fileSystem.h>
 #include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/tf/fileUtils.h>
+#include <pxr/base/work/dispatcher.h>
 #include <pxr/usd/ar/asset.h>
 #include <pxr/usd/ar/resolver.h>
 #include <pxr/usd/ar/resolvedPath.h>
+#include <pxr/usd/ar/resolverContext.h>
+#include <pxr/usd/ar/resolverContextBinder.h>
 
 #ifdef GUC_USE_OIIO
 #include <OpenImageIO/imageio.h>
@@ -31,7 +36,18 @@
 #endif
 
 #include <optional>
-#include <unordered_set>
+#include <system_error>
+#include <vector>
+
+#ifdef ARCH_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "cgltf_util.h"
 #include "debugCodes.h"
@@ -111,7 +127,8 @@ namespace detail
 
   bool readImageFromFile(const char* path,
                          size_t& size,
-                         std::shared_ptr<const char>& data)
+                         std::shared_ptr<const char>& data,
+                         std::string& resolvedPathStr)
   {
     TF_DEBUG(GUC).Msg("reading image %s\n", path);
 
@@ -126,7 +143,7 @@ namespace detail
       return false;
     }
 
-    std::string resolvedPathStr = resolvedPath.GetPathString();
+    resolvedPathStr = resolvedPath.GetPathString();
     TF_DEBUG(GUC).Msg("resolved path to %s\n", resolvedPathStr.c_str());
 
     std::shared_ptr<ArAsset> asset = resolver.OpenAsset(resolvedPath);
@@ -169,6 +186,138 @@ namespace detail
     return true;
   }
 
+  // Clones the file extents on copy-on-write filesystems like Btrfs and XFS
+  bool reflinkFile(const char* srcPath, const char* dstPath)
+  {
+#ifdef ARCH_OS_LINUX
+    int srcFd = open(srcPath, O_RDONLY | O_CLOEXEC);
+    if (srcFd == -1)
+    {
+      return false;
+    }
+
+    int dstFd = open(dstPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (dstFd == -1)
+    {
+      close(srcFd);
+      return false;
+    }
+
+    bool result = (ioctl(dstFd, FICLONE, srcFd) == 0);
+
+    close(dstFd);
+    close(srcFd);
+
+    if (!result)
+    {
+      unlink(dstPath);
+    }
+    return result;
+#else
+    return false;
+#endif
+  }
+
+  bool hardlinkFile(const char* srcPath, const char* dstPath)
+  {
+    std::error_code errorCode;
+    fs::remove(dstPath, errorCode);
+    fs::create_hard_link(srcPath, dstPath, errorCode);
+    return !errorCode;
+  }
+
+  // Copies the file without moving its contents through user space
+  bool kernelCopyFile(const char* srcPath, const char* dstPath)
+  {
+#ifdef ARCH_OS_LINUX
+    int srcFd = open(srcPath, O_RDONLY | O_CLOEXEC);
+    if (srcFd == -1)
+    {
+      return false;
+    }
+
+    struct stat srcStat;
+    if (fstat(srcFd, &srcStat) == -1)
+    {
+      close(srcFd);
+      return false;
+    }
+
+    int dstFd = open(dstPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (dstFd == -1)
+    {
+      close(srcFd);
+      return false;
+    }
+
+    off_t remaining = srcStat.st_size;
+    bool useSendfile = false;
+
+    while (remaining > 0)
+    {
+      ssize_t copied = -1;
+
+      if (!useSendfile)
+      {
+        copied = copy_file_range(srcFd, nullptr, dstFd, nullptr, remaining, 0);
+
+        // Not supported by kernel or across these filesystems
+        if (copied == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+        {
+          useSendfile = true;
+          continue;
+        }
+      }
+      else
+      {
+        copied = sendfile(dstFd, srcFd, nullptr, remaining);
+      }
+
+      if (copied <= 0)
+      {
+        break;
+      }
+      remaining -= copied;
+    }
+
+    close(dstFd);
+    close(srcFd);
+
+    if (remaining > 0)
+    {
+      unlink(dstPath);
+      return false;
+    }
+    return true;
+#else
+    // Uses the platform's native copy API
+    std::error_code errorCode;
+    fs::copy_file(srcPath, dstPath, fs::copy_options::overwrite_existing, errorCode);
+    return !errorCode;
+#endif
+  }
+
+  // Tries the strategies permitted by the copy mode, from the cheapest to the most expensive
+  bool copyImageFile(const char* srcPath, const char* dstPath, ImageCopyMode copyMode)
+  {
+    if (copyMode >= ImageCopyMode::Reflink && reflinkFile(srcPath, dstPath))
+    {
+      TF_DEBUG(GUC).Msg("reflinked img %s to %s\n", srcPath, dstPath);
+      return true;
+    }
+    if (copyMode >= ImageCopyMode::Hardlink && hardlinkFile(srcPath, dstPath))
+    {
+      TF_DEBUG(GUC).Msg("hardlinked img %s to %s\n", srcPath, dstPath);
+      return true;
+    }
+    if (copyMode >= ImageCopyMode::KernelCopy && kernelCopyFile(srcPath, dstPath))
+    {
+      TF_DEBUG(GUC).Msg("copied img %s to %s\n", srcPath, dstPath);
+      return true;
+    }
+    return false;
+  }
+
   bool readExtensionFromDataSignature(size_t size, const std::shared_ptr<const char>& data, std::string& extension)
   {
     const static std::array<uint8_t, 3> JPEG_HEADER = { 0xFF, 0xD8, 0xFF };
@@ -199,7 +348,7 @@ namespace detail
   bool decodeImageMetadata(const std::shared_ptr<const char>& buffer,
                            size_t bufferSize,
                            const char* path, // only a hint
-                           int& channelCount)
+                           ImageMetadata& metadata)
   {
 #ifdef GUC_USE_OIIO
     OIIO::Filesystem::IOMemReader memReader((void*) buffer.get(), bufferSize);
@@ -210,7 +359,7 @@ namespace detail
       assert(image->supports("ioproxy"));
 
       const OIIO::ImageSpec& spec = image->spec();
-      channelCount = spec.nchannels;
+      metadata.channelCount = spec.nchannels;
       image->close();
       return true;
     }
@@ -221,38 +370,31 @@ namespace detail
     }
 #else
     int width, height;
-    int ok = stbi_info_from_memory((const stbi_uc*) buffer.get(), bufferSize, &width, &height, &channelCount);
+    int ok = stbi_info_from_memory((const stbi_uc*) buffer.get(), bufferSize, &width, &height, &metadata.channelCount);
     if (ok)
     {
       return true;
     }
 #endif
-    TF_RUNTIME_ERROR("unable to open file for reading: %s", path);
+    TF_RUNTIME_ERROR("unable to decode image header: %s", path);
     return false;
   }
 
-  bool readImageMetadata(const char* path, int& channelCount)
-  {
-    size_t size;
-    std::shared_ptr<const char> data;
-    if (!readImageFromFile(path, size, data))
-    {
-      return false;
-    }
-
-    return decodeImageMetadata(data, size, path, channelCount);
-  }
-
-  std::optional<ImageMetadata> processImage(const cgltf_image* image,
-                                            const fs::path& srcDir,
-                                            const fs::path& dstDir,
-                                            bool copyExistingFiles,
-                                            bool genRelativePaths,
-                                            std::unordered_set<std::string>& generatedFileNames)
+  struct ImageSource
   {
     size_t size = 0;
     std::shared_ptr<const char> data;
     std::string srcFilePath;
+    std::string resolvedSrcFilePath;
+    std::string fileExt;
+    ImageMetadata metadata;
+  };
+
+  bool readImage(const cgltf_image* image, ImageSource& source)
+  {
+    size_t& size = source.size;
+    std::shared_ptr<const char>& data = source.data;
+    std::string& srcFilePath = source.srcFilePath;
 
     const char* uri = image->uri;
     if (uri && strncmp(uri, "data:", 5) == 0)
@@ -260,12 +402,12 @@ namespace detail
       const char* comma = strchr(uri, ',');
       if (comma && (comma - uri < 7 || strncmp(comma - 7, ";base64", 7) != 0))
       {
-        return std::nullopt;
+        return false;
       }
 
       if (!readImageDataFromBase64(comma + 1, size, data))
       {
-        return std::nullopt;
+        return false;
       }
     }
     else if (uri)
@@ -273,26 +415,25 @@ namespace detail
       srcFilePath = std::string(uri);
       cgltf_decode_uri(srcFilePath.data());
 
-      if (!readImageFromFile(srcFilePath.c_str(), size, data))
+      if (!readImageFromFile(srcFilePath.c_str(), size, data, source.resolvedSrcFilePath))
       {
-        return std::nullopt;
+        return false;
       }
     }
     else if (image->buffer_view)
     {
       if (!readImageDataFromBufferView(image->buffer_view, size, data))
       {
-        return std::nullopt;
+        return false;
       }
     }
     else
     {
       TF_WARN("no image source; probably defined by unsupported extension");
-      return std::nullopt;
+      return false;
     }
 
-    std::string fileExt;
-    if (!readExtensionFromDataSignature(size, data, fileExt))
+    if (!readExtensionFromDataSignature(size, data, source.fileExt))
     {
       // Doesn't matter what the mime type or path extension is if the image can not be read
       const char* hint = image->name;
@@ -305,9 +446,40 @@ namespace detail
         hint = "embedded";
       }
       TF_RUNTIME_ERROR("unable to determine image data type (hint: %s)", hint);
-      return std::nullopt;
+      return false;
     }
 
+    // Read the metadata required for MaterialX shading network creation directly from
+    // memory, instead of reading the file again after it has been written.
+    std::string hint = srcFilePath.empty() ? ("embedded" + source.fileExt) : srcFilePath;
+    if (!decodeImageMetadata(data, size, hint.c_str(), source.metadata))
+    {
+      TF_RUNTIME_ERROR("unable to read metadata of image %s", hint.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+  struct ImageExport
+  {
+    std::string dstFilePath;
+    std::string dstRefPath;
+    bool writeNewFile = false;
+  };
+
+  // Needs to be called in a deterministic order to not make file names depend on scheduling
+  ImageExport planImageExport(const cgltf_image* image,
+                              const ImageSource& source,
+                              const fs::path& dstDir,
+                              bool copyExistingFiles,
+                              bool genRelativePaths,
+                              const std::string& fileNamePrefix,
+                              SharedPathRegistry* sharedFilePaths,
+                              UniqueNameRegistry& generatedFileNames)
+  {
+    const std::string& srcFilePath = source.srcFilePath;
+
     bool genNewFileName = srcFilePath.empty() || genRelativePaths;
     bool writeNewFile = srcFilePath.empty() || copyExistingFiles;
 
@@ -315,9 +487,14 @@ namespace detail
     if (genNewFileName)
     {
       std::string srcFileName = fs::path(srcFilePath).filename().string();
-      std::string dstFileName = makeUniqueImageFileName(image->name, srcFileName, fileExt, generatedFileNames);
+      std::string dstFileName;
 
-      generatedFileNames.insert(dstFileName);
+      // Files written by other conversions into the same directory must not be overwritten
+      do
+      {
+        dstFileName = fileNamePrefix + makeUniqueImageFileName(image->name, srcFileName, source.fileExt, generatedFileNames);
+      }
+      while (writeNewFile && sharedFilePaths && !sharedFilePaths->reservePath(dstDir / dstFileName));
 
       dstRefPath = dstFileName;
     }
@@ -327,33 +504,85 @@ namespace detail
     {
       TF_VERIFY(genNewFileName); // Makes no sense to write a file to its source path
 
-      std::string writeFilePath = (dstDir / fs::path(dstRefPath)).string();
-      TF_DEBUG(GUC).Msg("writing img %s\n", writeFilePath.c_str());
-      if (!writeImageData(writeFilePath.c_str(), size, data))
+      dstFilePath = (dstDir / fs::path(dstRefPath)).string();
+
+      if (!genRelativePaths)
       {
-        return std::nullopt;
+        dstRefPath = dstFilePath;
       }
+    }
+
+    return ImageExport{ dstFilePath, dstRefPath, writeNewFile };
+  }
+
+  std::optional<ImageMetadata> exportImage(const ImageSource& source,
+                                           const ImageExport& imageExport,
+                                           ImageCopyMode copyMode,
+                                           bool keepImageData)
+  {
+    const std::string& dstFilePath = imageExport.dstFilePath;
+    const std::string& srcFilePath = source.resolvedSrcFilePath;
 
-      dstFilePath = writeFilePath;
+    bool isLocalSrcFile = !srcFilePath.empty() && TfIsFile(srcFilePath, /* resolveSymlinks */ true);
 
-      if (!genRelativePaths)
+    std::error_code errorCode;
+    if (keepImageData)
+    {
+      TF_DEBUG(GUC).Msg("keeping img %s in memory\n", dstFilePath.c_str());
+    }
+    else if (isLocalSrcFile && fs::equivalent(srcFilePath, dstFilePath, errorCode))
+    {
+      TF_DEBUG(GUC).Msg("img %s already exists at destination\n", srcFilePath.c_str());
+    }
+    else if (imageExport.writeNewFile)
+    {
+      bool copied = isLocalSrcFile && copyImageFile(srcFilePath.c_str(), dstFilePath.c_str(), copyMode);
+
+      if (!copied)
       {
-        dstRefPath = writeFilePath;
+        TF_DEBUG(GUC).Msg("writing img %s\n", dstFilePath.c_str());
+        if (!writeImageData(dstFilePath.c_str(), source.size, source.data))
+        {
+          return std::nullopt;
+        }
       }
     }
 
-    ImageMetadata metadata;
+    ImageMetadata metadata = source.metadata;
     metadata.filePath = dstFilePath;
-    metadata.refPath = dstRefPath;
+    metadata.refPath = imageExport.dstRefPath;
+    if (keepImageData)
+    {
+      metadata.data = source.data;
+      metadata.dataSize = source.size;
+    }
+    return metadata;
+  }
 
-    // Read the metadata required for MaterialX shading network creation
-    if (!readImageMetadata(dstFilePath.c_str(), metadata.channelCount))
+  template<typename Func>
+  void forEachImage(size_t imageCount, bool multithreaded, const Func& func)
+  {
+    if (!multithreaded)
     {
-      TF_RUNTIME_ERROR("unable to read metadata of image %s", dstFilePath.c_str());
-      return std::nullopt;
+      for (size_t i = 0; i < imageCount; i++)
+      {
+        func(i);
+      }
+      return;
     }
 
-    return metadata;
+    // Resolver contexts are bound per thread, so we need to forward the current one
+    ArResolverContext context = ArGetResolver().GetCurrentContext();
+
+    WorkDispatcher dispatcher;
+    for (size_t i = 0; i < imageCount; i++)
+    {
+      dispatcher.Run([&func, &context, i]() {
+        ArResolverContextBinder binder(context);
+        func(i);
+      });
+    }
+    dispatcher.Wait();
   }
 }
 
@@ -365,19 +594,55 @@ namespace guc
                      const fs::path& dstDir,
                      bool copyExistingFiles,
                      bool genRelativePaths,
+                     ImageCopyMode copyMode,
+                     bool keepImageData,
+                     bool multithreaded,
+                     const std::string& fileNamePrefix,
+                     SharedPathRegistry* sharedFilePaths,
                      ImageMetadataMap& metadata)
   {
-    std::unordered_set<std::string> generatedFileNames;
+    // Step 1: read image data, determine file types and decode headers
+    std::vector<detail::ImageSource> sources(imageCount);
+
+    detail::forEachImage(imageCount, multithreaded, [&](size_t i) {
+      if (!detail::readImage(&images[i], sources[i]))
+      {
+        sources[i].data = nullptr;
+      }
+    });
+
+    // Step 2: assign unique file names in image order
+    UniqueNameRegistry generatedFileNames;
+    std::vector<std::optional<detail::ImageExport>> exports(imageCount);
 
     for (size_t i = 0; i < imageCount; i++)
     {
-      const cgltf_image* image = &images[i];
+      const detail::ImageSource& source = sources[i];
+      if (!source.data)
+      {
+        continue;
+      }
 
-      auto meta = detail::processImage(image, srcDir, dstDir, copyExistingFiles, genRelativePaths, generatedFileNames);
+      exports[i] = detail::planImageExport(&images[i], source, dstDir, copyExistingFiles, genRelativePaths,
+                                           fileNamePrefix, sharedFilePaths, generatedFileNames);
+    }
+
+    // Step 3: write files or hand over their contents
+    std::vector<std::optional<ImageMetadata>> results(imageCount);
+
+    detail::forEachImage(imageCount, multithreaded, [&](size_t i) {
+      if (exports[i].has_value())
+      {
+        results[i] = detail::exportImage(sources[i], exports[i].value(), copyMode, keepImageData);
+      }
+      sources[i] = {}; // release image data early
+    });
 
-      if (meta.has_value())
+    for (size_t i = 0; i < imageCount; i++)
+    {
+      if (results[i].has_value())
       {
-        metadata[image] = meta.value();
+        metadata[&images[i]] = results[i].value();
       }
     }
 
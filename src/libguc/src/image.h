@@ -19,6 +19,7 @@
 #include <cgltf.h>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -26,20 +27,40 @@ namespace fs = std::filesystem;
 
 namespace guc
 {
+  class SharedPathRegistry;
+
   struct ImageMetadata
   {
     std::string filePath;
     std::string refPath;
-    int channelCount; // Needed to determine the type of MaterialX <image> nodes
+    int channelCount = 0; // Needed to determine the type of MaterialX <image> nodes
+    // Only set if image files are kept in memory instead of being written
+    std::shared_ptr<const char> data;
+    size_t dataSize = 0;
   };
 
   using ImageMetadataMap = std::unordered_map<const cgltf_image*, ImageMetadata>;
 
+  // Strategies for exporting existing image files, ordered from the most conservative
+  // to the most efficient. Each mode falls back to the preceding ones on failure.
+  enum class ImageCopyMode
+  {
+    Write = 0,  // Write image data from memory
+    KernelCopy, // Copy in kernel space (copy_file_range/sendfile or the platform's copy API)
+    Reflink,    // Share extents on copy-on-write filesystems
+    Hardlink    // Source and exported file share their contents; use with care
+  };
+
   void processImages(const cgltf_image* images,
                      size_t imageCount,
                      const fs::path& srcDir,
                      const fs::path& dstDir,
                      bool copyExistingFiles,
                      bool genRelativePaths,
+                     ImageCopyMode copyMode,
+                     bool keepImageData,
+                     bool multithreaded,
+                     const std::string& fileNamePrefix,
+                     SharedPathRegistry* sharedFilePaths,
                      ImageMetadataMap& metadata);
 }
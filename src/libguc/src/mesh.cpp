@@ -19,11 +19,527 @@
 #include <pxr/base/gf/vec2f.h>
 #include <pxr/base/gf/vec3f.h>
 #include <pxr/base/tf/diagnostic.h>
+#include <pxr/base/work/loops.h>
 
 #include <mikktspace.h>
+#include <meshoptimizer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
 
 #include "debugCodes.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GUC_SIMD_SSE2
+#define GUC_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GUC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(GUC_SIMD_AVX2) && !defined(_MSC_VER)
+#define GUC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GUC_TARGET_AVX2
+#endif
+
+#if defined(GUC_SIMD_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace detail
+{
+  // Relative to the mesh extents
+  constexpr static float SIMPLIFICATION_TARGET_ERROR = 0.01f;
+
+  // Fraction of the target triangle count by which regular simplification may overshoot
+  constexpr static float SIMPLIFICATION_TARGET_TOLERANCE = 0.1f;
+
+  // Same as GF_MIN_VECTOR_LENGTH, which is used by GfVec3f::Normalize
+  constexpr static float MIN_VECTOR_LENGTH = 1e-10f;
+
+  // Faces per tangent generation chunk. Meshes are chunked the same way with and without
+  // multithreading, so that the output does not depend on it.
+  constexpr static size_t TANGENT_CHUNK_FACE_COUNT = 16384;
+
+  // A subset of faces for which MikkTSpace is run. Only the results of the first
+  // ownedFaceCount faces are written; the other faces provide tangent space context.
+  struct TangentChunk
+  {
+    const int* faces; // identity if null
+    int faceCount;
+    int ownedFaceCount;
+  };
+
+  int getTangentCornerIndex(const TangentChunk& chunk, int iFace, int iVert)
+  {
+    int face = chunk.faces ? chunk.faces[iFace] : iFace;
+    return face * 3 + iVert;
+  }
+
+  // Chunks write to distinct elements of the output arrays
+  bool generateTangentChunk(const VtIntArray& indices,
+                            const VtVec3fArray& positions,
+                            const VtVec3fArray& normals,
+                            const VtIntArray& normalIndices,
+                            const VtVec2fArray& texcoords,
+                            const TangentChunk& chunk,
+                            float* unindexedSigns,
+                            GfVec3f* unindexedTangents)
+  {
+    struct UserData {
+      const VtIntArray& indices;
+      const VtVec3fArray& positions;
+      const VtVec3fArray& normals;
+      const VtIntArray& normalIndices;
+      const VtVec2fArray& texcoords;
+      const TangentChunk& chunk;
+      float* unindexedSigns;
+      GfVec3f* unindexedTangents;
+    } userData = {
+      indices, positions, normals, normalIndices, texcoords, chunk, unindexedSigns, unindexedTangents
+    };
+
+    auto getNumFacesFunc = [](const SMikkTSpaceContext* pContext) {
+      UserData* userData = (UserData*) pContext->m_pUserData;
+      return userData->chunk.faceCount;
+    };
+
+    auto getNumVerticesOfFaceFunc = [](const SMikkTSpaceContext* pContext, const int iFace) {
+      return 3;
+    };
+
+    auto getPositionFunc = [](const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert) {
+      UserData* userData = (UserData*) pContext->m_pUserData;
+      int vertexIndex = userData->indices[getTangentCornerIndex(userData->chunk, iFace, iVert)];
+      const GfVec3f& position = userData->positions[vertexIndex];
+      fvPosOut[0] = position[0];
+      fvPosOut[1] = position[1];
+      fvPosOut[2] = position[2];
+    };
+
+    auto getNormalFunc = [](const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert) {
+      UserData* userData = (UserData*) pContext->m_pUserData;
+      int normalIndex = userData->normalIndices[getTangentCornerIndex(userData->chunk, iFace, iVert)];
+      const GfVec3f& normal = userData->normals[normalIndex];
+      fvNormOut[0] = normal[0];
+      fvNormOut[1] = normal[1];
+      fvNormOut[2] = normal[2];
+    };
+
+    auto getTexCoordFunc = [](const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert) {
+      UserData* userData = (UserData*) pContext->m_pUserData;
+      int vertexIndex = userData->indices[getTangentCornerIndex(userData->chunk, iFace, iVert)];
+      const GfVec2f& texcoord = userData->texcoords[vertexIndex];
+      fvTexcOut[0] = texcoord[0];
+      fvTexcOut[1] = texcoord[1];
+    };
+
+    auto setTSpaceBasicFunc = [](const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert) {
+      UserData* userData = (UserData*) pContext->m_pUserData;
+      if (iFace >= userData->chunk.ownedFaceCount)
+      {
+        return;
+      }
+      int newVertexIndex = getTangentCornerIndex(userData->chunk, iFace, iVert);
+      userData->unindexedTangents[newVertexIndex] = GfVec3f(fvTangent[0], fvTangent[1], fvTangent[2]);
+      userData->unindexedSigns[newVertexIndex] = fSign;
+    };
+
+    SMikkTSpaceInterface interface;
+    interface.m_getNumFaces = getNumFacesFunc;
+    interface.m_getNumVerticesOfFace= getNumVerticesOfFaceFunc;
+    interface.m_getPosition = getPositionFunc;
+    interface.m_getNormal = getNormalFunc;
+    interface.m_getTexCoord = getTexCoordFunc;
+    interface.m_setTSpaceBasic = setTSpaceBasicFunc;
+    interface.m_setTSpace = nullptr;
+
+    SMikkTSpaceContext context;
+    context.m_pInterface = &interface;
+    context.m_pUserData = &userData;
+
+    return genTangSpaceDefault(&context);
+  }
+
+  //
+  // Geometry kernels. The float arrays are tightly packed vectors of 2, 3 or 4 components.
+  //
+
+  struct GeometryKernels
+  {
+    const char* name;
+    void (*computeFaceNormals)(const int* indices, size_t faceCount, const float* positions, float* faceNormals);
+    void (*flipTexCoordsY)(float* texCoords, size_t count);
+    void (*multiplyVec3s)(float* values, size_t count, const float* factor);
+    void (*multiplyFloats)(float* values, size_t count, float factor);
+    void (*splitVec4s)(const float* src, size_t count, float* xyz, float* w);
+  };
+
+  void normalizeScalar(float& x, float& y, float& z)
+  {
+    float length = std::sqrt(x * x + y * y + z * z);
+    length = (length > MIN_VECTOR_LENGTH) ? length : MIN_VECTOR_LENGTH;
+    x /= length;
+    y /= length;
+    z /= length;
+  }
+
+  void computeFaceNormalsScalar(const int* indices, size_t faceCount, const float* positions, float* faceNormals)
+  {
+    for (size_t i = 0; i < faceCount; i++)
+    {
+      const float* p0 = &positions[indices[i * 3 + 0] * 3];
+      const float* p1 = &positions[indices[i * 3 + 1] * 3];
+      const float* p2 = &positions[indices[i * 3 + 2] * 3];
+
+      float e1x = p1[0] - p0[0], e1y = p1[1] - p0[1], e1z = p1[2] - p0[2];
+      float e2x = p2[0] - p0[0], e2y = p2[1] - p0[1], e2z = p2[2] - p0[2];
+      normalizeScalar(e1x, e1y, e1z);
+      normalizeScalar(e2x, e2y, e2z);
+
+      float nx = e1y * e2z - e1z * e2y;
+      float ny = e1z * e2x - e1x * e2z;
+      float nz = e1x * e2y - e1y * e2x;
+      normalizeScalar(nx, ny, nz);
+
+      faceNormals[i * 3 + 0] = nx;
+      faceNormals[i * 3 + 1] = ny;
+      faceNormals[i * 3 + 2] = nz;
+    }
+  }
+
+  void flipTexCoordsYScalar(float* texCoords, size_t count)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      texCoords[i * 2 + 1] = 1.0f - texCoords[i * 2 + 1];
+    }
+  }
+
+  void multiplyVec3sScalar(float* values, size_t count, const float* factor)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      values[i * 3 + 0] *= factor[0];
+      values[i * 3 + 1] *= factor[1];
+      values[i * 3 + 2] *= factor[2];
+    }
+  }
+
+  void multiplyFloatsScalar(float* values, size_t count, float factor)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      values[i] *= factor;
+    }
+  }
+
+  void splitVec4sScalar(const float* src, size_t count, float* xyz, float* w)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      xyz[i * 3 + 0] = src[i * 4 + 0];
+      xyz[i * 3 + 1] = src[i * 4 + 1];
+      xyz[i * 3 + 2] = src[i * 4 + 2];
+    }
+    if (w)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        w[i] = src[i * 4 + 3];
+      }
+    }
+  }
+
+#if defined(GUC_SIMD_SSE2) || defined(GUC_SIMD_NEON)
+  // Minimal 4-wide vector abstraction, so that the SSE2 and NEON kernels share their code
+#if defined(GUC_SIMD_SSE2)
+  using Float4 = __m128;
+  inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+  inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+  inline Float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+  inline Float4 splat4(float a) { return _mm_set1_ps(a); }
+  inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+  inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+  inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+  inline Float4 div4(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+  inline Float4 sqrt4(Float4 a) { return _mm_sqrt_ps(a); }
+  inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+#else
+  using Float4 = float32x4_t;
+  inline Float4 load4(const float* p) { return vld1q_f32(p); }
+  inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+  inline Float4 set4(float a, float b, float c, float d) { const float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+  inline Float4 splat4(float a) { return vdupq_n_f32(a); }
+  inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+  inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+  inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+  inline Float4 div4(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+  inline Float4 sqrt4(Float4 a) { return vsqrtq_f32(a); }
+  inline Float4 max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+#endif
+
+  inline void normalize4(Float4& x, Float4& y, Float4& z)
+  {
+    Float4 length = sqrt4(add4(add4(mul4(x, x), mul4(y, y)), mul4(z, z)));
+    length = max4(length, splat4(MIN_VECTOR_LENGTH));
+    x = div4(x, length);
+    y = div4(y, length);
+    z = div4(z, length);
+  }
+
+  // Processes four faces at a time in SoA layout. Positions are gathered in scalar code,
+  // since they are addressed indirectly.
+  void computeFaceNormals4(const int* indices, size_t faceCount, const float* positions, float* faceNormals)
+  {
+    size_t blockCount = faceCount / 4;
+    for (size_t b = 0; b < blockCount; b++)
+    {
+      alignas(16) float p[3][3][4]; // corner, component, face
+      for (int f = 0; f < 4; f++)
+      {
+        for (int c = 0; c < 3; c++)
+        {
+          const float* pos = &positions[indices[(b * 4 + f) * 3 + c] * 3];
+          p[c][0][f] = pos[0];
+          p[c][1][f] = pos[1];
+          p[c][2][f] = pos[2];
+        }
+      }
+
+      Float4 p0x = load4(p[0][0]), p0y = load4(p[0][1]), p0z = load4(p[0][2]);
+      Float4 e1x = sub4(load4(p[1][0]), p0x), e1y = sub4(load4(p[1][1]), p0y), e1z = sub4(load4(p[1][2]), p0z);
+      Float4 e2x = sub4(load4(p[2][0]), p0x), e2y = sub4(load4(p[2][1]), p0y), e2z = sub4(load4(p[2][2]), p0z);
+      normalize4(e1x, e1y, e1z);
+      normalize4(e2x, e2y, e2z);
+
+      Float4 nx = sub4(mul4(e1y, e2z), mul4(e1z, e2y));
+      Float4 ny = sub4(mul4(e1z, e2x), mul4(e1x, e2z));
+      Float4 nz = sub4(mul4(e1x, e2y), mul4(e1y, e2x));
+      normalize4(nx, ny, nz);
+
+      alignas(16) float n[3][4];
+      store4(n[0], nx);
+      store4(n[1], ny);
+      store4(n[2], nz);
+
+      float* dst = &faceNormals[b * 4 * 3];
+      for (int f = 0; f < 4; f++)
+      {
+        dst[f * 3 + 0] = n[0][f];
+        dst[f * 3 + 1] = n[1][f];
+        dst[f * 3 + 2] = n[2][f];
+      }
+    }
+
+    size_t first = blockCount * 4;
+    computeFaceNormalsScalar(&indices[first * 3], faceCount - first, positions, &faceNormals[first * 3]);
+  }
+
+  void flipTexCoordsY4(float* texCoords, size_t count)
+  {
+    // (x, y) -> (x, 1 - y) for two texture coordinates at a time
+    Float4 scale = set4(1.0f, -1.0f, 1.0f, -1.0f);
+    Float4 offset = set4(0.0f, 1.0f, 0.0f, 1.0f);
+
+    size_t pairCount = count / 2;
+    for (size_t i = 0; i < pairCount; i++)
+    {
+      float* p = &texCoords[i * 4];
+      store4(p, add4(mul4(load4(p), scale), offset));
+    }
+
+    flipTexCoordsYScalar(&texCoords[pairCount * 4], count - pairCount * 2);
+  }
+
+  void multiplyVec3s4(float* values, size_t count, const float* factor)
+  {
+    // The factor pattern repeats every 12 floats (four vectors)
+    Float4 f0 = set4(factor[0], factor[1], factor[2], factor[0]);
+    Float4 f1 = set4(factor[1], factor[2], factor[0], factor[1]);
+    Float4 f2 = set4(factor[2], factor[0], factor[1], factor[2]);
+
+    size_t blockCount = count / 4;
+    for (size_t i = 0; i < blockCount; i++)
+    {
+      float* p = &values[i * 12];
+      store4(p + 0, mul4(load4(p + 0), f0));
+      store4(p + 4, mul4(load4(p + 4), f1));
+      store4(p + 8, mul4(load4(p + 8), f2));
+    }
+
+    multiplyVec3sScalar(&values[blockCount * 12], count - blockCount * 4, factor);
+  }
+
+  void multiplyFloats4(float* values, size_t count, float factor)
+  {
+    Float4 f = splat4(factor);
+
+    size_t blockCount = count / 4;
+    for (size_t i = 0; i < blockCount; i++)
+    {
+      float* p = &values[i * 4];
+      store4(p, mul4(load4(p), f));
+    }
+
+    multiplyFloatsScalar(&values[blockCount * 4], count - blockCount * 4, factor);
+  }
+
+  void splitVec4s4(const float* src, size_t count, float* xyz, float* w)
+  {
+    // Each store writes one float past the vector, which is overwritten by the next
+    // store. The last vector is copied in scalar code to stay within bounds.
+    size_t vectorCount = (count > 0) ? (count - 1) : 0;
+    for (size_t i = 0; i < vectorCount; i++)
+    {
+      store4(&xyz[i * 3], load4(&src[i * 4]));
+    }
+
+    splitVec4sScalar(&src[vectorCount * 4], count - vectorCount, &xyz[vectorCount * 3], nullptr);
+
+    if (w)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        w[i] = src[i * 4 + 3];
+      }
+    }
+  }
+#endif
+
+#ifdef GUC_SIMD_AVX2
+  GUC_TARGET_AVX2 void flipTexCoordsYAvx2(float* texCoords, size_t count)
+  {
+    __m256 scale = _mm256_setr_ps(1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f);
+    __m256 offset = _mm256_setr_ps(0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f);
+
+    size_t blockCount = count / 4;
+    for (size_t i = 0; i < blockCount; i++)
+    {
+      float* p = &texCoords[i * 8];
+      _mm256_storeu_ps(p, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p), scale), offset));
+    }
+
+    flipTexCoordsYScalar(&texCoords[blockCount * 8], count - blockCount * 4);
+  }
+
+  GUC_TARGET_AVX2 void multiplyVec3sAvx2(float* values, size_t count, const float* factor)
+  {
+    // The factor pattern repeats every 24 floats (eight vectors)
+    float pattern[24];
+    for (int i = 0; i < 24; i++)
+    {
+      pattern[i] = factor[i % 3];
+    }
+    __m256 f0 = _mm256_loadu_ps(&pattern[0]);
+    __m256 f1 = _mm256_loadu_ps(&pattern[8]);
+    __m256 f2 = _mm256_loadu_ps(&pattern[16]);
+
+    size_t blockCount = count / 8;
+    for (size_t i = 0; i < blockCount; i++)
+    {
+      float* p = &values[i * 24];
+      _mm256_storeu_ps(p + 0, _mm256_mul_ps(_mm256_loadu_ps(p + 0), f0));
+      _mm256_storeu_ps(p + 8, _mm256_mul_ps(_mm256_loadu_ps(p + 8), f1));
+      _mm256_storeu_ps(p + 16, _mm256_mul_ps(_mm256_loadu_ps(p + 16), f2));
+    }
+
+    multiplyVec3sScalar(&values[blockCount * 24], count - blockCount * 8, factor);
+  }
+
+  GUC_TARGET_AVX2 void multiplyFloatsAvx2(float* values, size_t count, float factor)
+  {
+    __m256 f = _mm256_set1_ps(factor);
+
+    size_t blockCount = count / 8;
+    for (size_t i = 0; i < blockCount; i++)
+    {
+      float* p = &values[i * 8];
+      _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_loadu_ps(p), f));
+    }
+
+    multiplyFloatsScalar(&values[blockCount * 8], count - blockCount * 8, factor);
+  }
+
+  bool cpuSupportsAvx2()
+  {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+      return false;
+    }
+
+    // The OS must save the YMM registers on context switches
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+    {
+      return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+  }
+#endif
+
+  GeometryKernels selectGeometryKernels()
+  {
+    GeometryKernels kernels = {
+      "scalar",
+      computeFaceNormalsScalar,
+      flipTexCoordsYScalar,
+      multiplyVec3sScalar,
+      multiplyFloatsScalar,
+      splitVec4sScalar
+    };
+
+#if defined(GUC_SIMD_SSE2) || defined(GUC_SIMD_NEON)
+#if defined(GUC_SIMD_SSE2)
+    kernels.name = "SSE2";
+#else
+    kernels.name = "NEON";
+#endif
+    kernels.computeFaceNormals = computeFaceNormals4;
+    kernels.flipTexCoordsY = flipTexCoordsY4;
+    kernels.multiplyVec3s = multiplyVec3s4;
+    kernels.multiplyFloats = multiplyFloats4;
+    kernels.splitVec4s = splitVec4s4;
+#endif
+
+#ifdef GUC_SIMD_AVX2
+    // The remaining kernels are bound by memory accesses and do not profit from wider vectors
+    if (cpuSupportsAvx2())
+    {
+      kernels.name = "AVX2";
+      kernels.flipTexCoordsY = flipTexCoordsYAvx2;
+      kernels.multiplyVec3s = multiplyVec3sAvx2;
+      kernels.multiplyFloats = multiplyFloatsAvx2;
+    }
+#endif
+
+    return kernels;
+  }
+
+  const GeometryKernels& getGeometryKernels()
+  {
+    static const GeometryKernels s_kernels = [] {
+      GeometryKernels kernels = selectGeometryKernels();
+      TF_DEBUG(GUC).Msg("using %s geometry kernels\n", kernels.name);
+      return kernels;
+    }();
+    return s_kernels;
+  }
+}
+
 namespace guc
 {
   bool createGeometryRepresentation(const cgltf_primitive* prim,
@@ -142,111 +658,388 @@ namespace guc
                          VtVec3fArray& normals)
   {
     TF_VERIFY((indices.size() % 3) == 0);
+    size_t faceCount = indices.size() / 3;
+
+    std::vector<GfVec3f> faceNormals(faceCount);
+    detail::getGeometryKernels().computeFaceNormals(indices.cdata(), faceCount, (const float*) positions.cdata(),
+                                                    (float*) faceNormals.data());
+
     normals.resize(positions.size());
+    GfVec3f* normalData = normals.data();
 
-    for (size_t i = 0; i < indices.size(); i += 3)
+    for (size_t i = 0; i < faceCount; i++)
+    {
+      const GfVec3f& n = faceNormals[i];
+      normalData[indices[i * 3 + 0]] = n;
+      normalData[indices[i * 3 + 1]] = n;
+      normalData[indices[i * 3 + 2]] = n;
+    }
+  }
+
+  void createFlatNormals(const VtIntArray& indices,
+                         const VtVec3fArray& positions,
+                         VtVec3fArray& normals,
+                         VtIntArray& normalIndices)
+  {
+    TF_VERIFY((indices.size() % 3) == 0);
+    size_t faceCount = indices.size() / 3;
+
+    std::vector<GfVec3f> faceNormals(faceCount);
+    detail::getGeometryKernels().computeFaceNormals(indices.cdata(), faceCount, (const float*) positions.cdata(),
+                                                    (float*) faceNormals.data());
+
+    // Coplanar faces share their normal
+    std::vector<unsigned int> remap;
+    size_t normalCount = generateUniqueElementRemap({ { faceNormals.data(), sizeof(GfVec3f) } }, faceCount, remap);
+
+    normals.resize(normalCount);
+    for (size_t i = 0; i < faceCount; i++)
+    {
+      normals[remap[i]] = faceNormals[i];
+    }
+
+    normalIndices.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); i++)
     {
-      int i0 = indices[i + 0];
-      int i1 = indices[i + 1];
-      int i2 = indices[i + 2];
+      normalIndices[i] = remap[i / 3];
+    }
+  }
 
-      const GfVec3f& p0 = positions[i0];
-      const GfVec3f& p1 = positions[i1];
-      const GfVec3f& p2 = positions[i2];
+  void flipTexCoordsY(VtVec2fArray& texCoords)
+  {
+    detail::getGeometryKernels().flipTexCoordsY((float*) texCoords.data(), texCoords.size());
+  }
 
-      GfVec3f e1 = (p1 - p0);
-      GfVec3f e2 = (p2 - p0);
-      e1.Normalize();
-      e2.Normalize();
+  void multiplyComponents(VtVec3fArray& values, const GfVec3f& factor)
+  {
+    detail::getGeometryKernels().multiplyVec3s((float*) values.data(), values.size(), factor.data());
+  }
 
-      GfVec3f n = GfCross(e1, e2);
-      n.Normalize();
+  void multiplyValues(VtFloatArray& values, float factor)
+  {
+    detail::getGeometryKernels().multiplyFloats(values.data(), values.size(), factor);
+  }
 
-      normals[i0] = n;
-      normals[i1] = n;
-      normals[i2] = n;
+  void splitVec4Array(const VtVec4fArray& src, VtVec3fArray& xyz, VtFloatArray* w)
+  {
+    xyz.resize(src.size());
+    if (w)
+    {
+      w->resize(src.size());
     }
+
+    detail::getGeometryKernels().splitVec4s((const float*) src.cdata(), src.size(), (float*) xyz.data(), w ? w->data() : nullptr);
   }
 
   bool createTangents(const VtIntArray& indices,
                       const VtVec3fArray& positions,
                       const VtVec3fArray& normals,
+                      const VtIntArray& normalIndices,
                       const VtVec2fArray& texcoords,
                       VtFloatArray& unindexedSigns,
-                      VtVec3fArray& unindexedTangents)
+                      VtVec3fArray& unindexedTangents,
+                      bool multithreaded)
   {
     TF_VERIFY(!texcoords.empty());
+    TF_VERIFY((indices.size() % 3) == 0);
 
-    int vertexCount = indices.size();
-    unindexedTangents.resize(vertexCount);
-    unindexedSigns.resize(vertexCount);
+    size_t faceCount = indices.size() / 3;
+    unindexedTangents.resize(indices.size());
+    unindexedSigns.resize(indices.size());
 
-    struct UserData {
-      const VtIntArray& indices;
-      const VtVec3fArray& positions;
-      const VtVec3fArray& normals;
-      const VtVec2fArray& texcoords;
-      VtFloatArray& unindexedSigns;
-      VtVec3fArray& unindexedTangents;
-    } userData = {
-      indices, positions, normals, texcoords, unindexedSigns, unindexedTangents
-    };
+    float* signData = unindexedSigns.data();
+    GfVec3f* tangentData = unindexedTangents.data();
 
-    auto getNumFacesFunc = [](const SMikkTSpaceContext* pContext) {
-      UserData* userData = (UserData*) pContext->m_pUserData;
-      return (int) userData->indices.size() / 3;
-    };
+    if (faceCount <= detail::TANGENT_CHUNK_FACE_COUNT)
+    {
+      detail::TangentChunk chunk = { nullptr, int(faceCount), int(faceCount) };
+      return detail::generateTangentChunk(indices, positions, normals, normalIndices, texcoords,
+                                          chunk, signData, tangentData);
+    }
 
-    auto getNumVerticesOfFaceFunc = [](const SMikkTSpaceContext* pContext, const int iFace) {
-      return 3;
-    };
+    // MikkTSpace averages the tangents of faces that share a vertex with the same position,
+    // normal and texture coordinate. We weld vertices in the same way, so that each chunk
+    // can be extended by the faces around its vertices. The owned faces then get the same
+    // results as for the whole mesh, except for the summation order of the averages.
+    size_t cornerCount = indices.size();
+    std::vector<GfVec3f> cornerPositions(cornerCount);
+    std::vector<GfVec3f> cornerNormals(cornerCount);
+    std::vector<GfVec2f> cornerTexcoords(cornerCount);
+    // Adding zero turns -0 into +0, as they compare equal in MikkTSpace but not bitwise
+    for (size_t i = 0; i < cornerCount; i++)
+    {
+      cornerPositions[i] = positions[indices[i]] + GfVec3f(0.0f);
+      cornerNormals[i] = normals[normalIndices[i]] + GfVec3f(0.0f);
+      cornerTexcoords[i] = texcoords[indices[i]] + GfVec2f(0.0f);
+    }
 
-    auto getPositionFunc = [](const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert) {
-      UserData* userData = (UserData*) pContext->m_pUserData;
-      int vertexIndex = userData->indices[iFace * 3 + iVert];
-      const GfVec3f& position = userData->positions[vertexIndex];
-      fvPosOut[0] = position[0];
-      fvPosOut[1] = position[1];
-      fvPosOut[2] = position[2];
-    };
+    std::vector<unsigned int> weldedVertices;
+    size_t weldedVertexCount = generateUniqueElementRemap({ { cornerPositions.data(), sizeof(GfVec3f) },
+                                                            { cornerNormals.data(), sizeof(GfVec3f) },
+                                                            { cornerTexcoords.data(), sizeof(GfVec2f) } },
+                                                          cornerCount, weldedVertices);
 
-    auto getNormalFunc = [](const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert) {
-      UserData* userData = (UserData*) pContext->m_pUserData;
-      int vertexIndex = userData->indices[iFace * 3 + iVert];
-      const GfVec3f& normal = userData->normals[vertexIndex];
-      fvNormOut[0] = normal[0];
-      fvNormOut[1] = normal[1];
-      fvNormOut[2] = normal[2];
-    };
+    // Faces around each welded vertex, in CSR layout
+    std::vector<unsigned int> vertexFaceOffsets(weldedVertexCount + 1, 0);
+    for (unsigned int v : weldedVertices)
+    {
+      vertexFaceOffsets[v + 1]++;
+    }
+    for (size_t i = 0; i < weldedVertexCount; i++)
+    {
+      vertexFaceOffsets[i + 1] += vertexFaceOffsets[i];
+    }
 
-    auto getTexCoordFunc = [](const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert) {
-      UserData* userData = (UserData*) pContext->m_pUserData;
-      int vertexIndex = userData->indices[iFace * 3 + iVert];
-      const GfVec2f& texcoord = userData->texcoords[vertexIndex];
-      fvTexcOut[0] = texcoord[0];
-      fvTexcOut[1] = texcoord[1];
-    };
+    std::vector<int> vertexFaces(cornerCount);
+    std::vector<unsigned int> vertexFaceCounts(weldedVertexCount, 0);
+    for (size_t i = 0; i < cornerCount; i++)
+    {
+      unsigned int v = weldedVertices[i];
+      vertexFaces[vertexFaceOffsets[v] + vertexFaceCounts[v]++] = int(i / 3);
+    }
 
-    auto setTSpaceBasicFunc = [](const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert) {
-      UserData* userData = (UserData*) pContext->m_pUserData;
-      int newVertexIndex = iFace * 3 + iVert;
-      userData->unindexedTangents[newVertexIndex] = GfVec3f(fvTangent[0], fvTangent[1], fvTangent[2]);
-      userData->unindexedSigns[newVertexIndex] = fSign;
+    size_t chunkCount = (faceCount + detail::TANGENT_CHUNK_FACE_COUNT - 1) / detail::TANGENT_CHUNK_FACE_COUNT;
+    std::atomic<bool> result(true);
+
+    const auto generateChunks = [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; c++)
+      {
+        int firstFace = int(c * detail::TANGENT_CHUNK_FACE_COUNT);
+        int lastFace = int(std::min(faceCount, (c + 1) * detail::TANGENT_CHUNK_FACE_COUNT));
+
+        std::vector<int> faces;
+        for (int f = firstFace; f < lastFace; f++)
+        {
+          faces.push_back(f);
+        }
+
+        std::vector<int> ringFaces;
+        for (size_t i = size_t(firstFace) * 3; i < size_t(lastFace) * 3; i++)
+        {
+          unsigned int v = weldedVertices[i];
+          for (unsigned int k = vertexFaceOffsets[v]; k < vertexFaceOffsets[v + 1]; k++)
+          {
+            int f = vertexFaces[k];
+            if (f < firstFace || f >= lastFace)
+            {
+              ringFaces.push_back(f);
+            }
+          }
+        }
+
+        std::sort(ringFaces.begin(), ringFaces.end());
+        ringFaces.erase(std::unique(ringFaces.begin(), ringFaces.end()), ringFaces.end());
+        faces.insert(faces.end(), ringFaces.begin(), ringFaces.end());
+
+        detail::TangentChunk chunk = { faces.data(), int(faces.size()), lastFace - firstFace };
+        if (!detail::generateTangentChunk(indices, positions, normals, normalIndices, texcoords,
+                                          chunk, signData, tangentData))
+        {
+          result = false;
+        }
+      }
     };
 
-    SMikkTSpaceInterface interface;
-    interface.m_getNumFaces = getNumFacesFunc;
-    interface.m_getNumVerticesOfFace= getNumVerticesOfFaceFunc;
-    interface.m_getPosition = getPositionFunc;
-    interface.m_getNormal = getNormalFunc;
-    interface.m_getTexCoord = getTexCoordFunc;
-    interface.m_setTSpaceBasic = setTSpaceBasicFunc;
-    interface.m_setTSpace = nullptr;
+    // Threading only affects scheduling, as each chunk is generated independently
+    if (multithreaded)
+    {
+      WorkParallelForN(chunkCount, generateChunks);
+    }
+    else
+    {
+      generateChunks(0, chunkCount);
+    }
 
-    SMikkTSpaceContext context;
-    context.m_pInterface = &interface;
-    context.m_pUserData = &userData;
+    TF_DEBUG(GUC).Msg("generated tangents in %d chunks\n", int(chunkCount));
 
-    return genTangSpaceDefault(&context);
+    return result;
+  }
+
+  void weldTangentFrames(VtIntArray& indices,
+                         VtVec3fArray& tangents,
+                         VtFloatArray& signs,
+                         VtIntArray& sourceVertices)
+  {
+    size_t cornerCount = indices.size();
+
+    std::vector<unsigned int> remap;
+    size_t vertexCount = generateUniqueElementRemap({ { indices.cdata(), sizeof(int) },
+                                                      { tangents.cdata(), sizeof(GfVec3f) },
+                                                      { signs.cdata(), sizeof(float) } },
+                                                    cornerCount, remap);
+
+    VtVec3fArray newTangents(vertexCount);
+    VtFloatArray newSigns(vertexCount);
+    sourceVertices.resize(vertexCount);
+
+    for (size_t i = 0; i < cornerCount; i++)
+    {
+      unsigned int v = remap[i];
+      sourceVertices[v] = indices[i];
+      newTangents[v] = tangents[i];
+      newSigns[v] = signs[i];
+      indices[i] = int(v);
+    }
+
+    TF_DEBUG(GUC).Msg("welded %d tangent frames to %d vertices\n", int(cornerCount), int(vertexCount));
+
+    tangents = std::move(newTangents);
+    signs = std::move(newSigns);
+  }
+
+  size_t generateUniqueElementRemap(const std::vector<VertexStream>& streams,
+                                    size_t elementCount,
+                                    std::vector<unsigned int>& remap)
+  {
+    std::vector<meshopt_Stream> meshoptStreams;
+    meshoptStreams.reserve(streams.size());
+    for (const VertexStream& stream : streams)
+    {
+      meshoptStreams.push_back({ stream.data, stream.elementSize, stream.elementSize });
+    }
+
+    remap.resize(elementCount);
+    return meshopt_generateVertexRemapMulti(remap.data(), nullptr, elementCount, elementCount,
+                                            meshoptStreams.data(), meshoptStreams.size());
+  }
+
+  void optimizeTriangleMesh(VtIntArray& indices,
+                            const VtVec3fArray& positions,
+                            const std::vector<VertexStream>& streams,
+                            std::vector<unsigned int>& remap,
+                            size_t& newVertexCount)
+  {
+    TF_VERIFY((indices.size() % 3) == 0);
+
+    size_t vertexCount = positions.size();
+    const GfVec3f* positionData = positions.cdata();
+
+    // Remove degenerate triangles. Zero-area triangles do not contribute to the surface.
+    std::vector<unsigned int> newIndices;
+    newIndices.reserve(indices.size());
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+      unsigned int i0 = indices[i + 0];
+      unsigned int i1 = indices[i + 1];
+      unsigned int i2 = indices[i + 2];
+
+      if (i0 == i1 || i1 == i2 || i2 == i0)
+      {
+        continue;
+      }
+
+      const GfVec3f& p0 = positionData[i0];
+      GfVec3f n = GfCross(positionData[i1] - p0, positionData[i2] - p0);
+      if (n == GfVec3f(0.0f))
+      {
+        continue;
+      }
+
+      newIndices.push_back(i0);
+      newIndices.push_back(i1);
+      newIndices.push_back(i2);
+    }
+
+    size_t indexCount = newIndices.size();
+    TF_DEBUG(GUC).Msg("removed %d degenerate triangles\n", int((indices.size() - indexCount) / 3));
+
+    // Weld vertices that have the same value in all streams; unreferenced vertices are dropped
+    std::vector<meshopt_Stream> meshoptStreams;
+    meshoptStreams.reserve(streams.size() + 1);
+    meshoptStreams.push_back({ positionData, sizeof(GfVec3f), sizeof(GfVec3f) });
+    for (const VertexStream& stream : streams)
+    {
+      meshoptStreams.push_back({ stream.data, stream.elementSize, stream.elementSize });
+    }
+
+    remap.resize(vertexCount);
+    newVertexCount = meshopt_generateVertexRemapMulti(remap.data(), newIndices.data(), indexCount, vertexCount,
+                                                      meshoptStreams.data(), meshoptStreams.size());
+
+    meshopt_remapIndexBuffer(newIndices.data(), newIndices.data(), indexCount, remap.data());
+
+    TF_DEBUG(GUC).Msg("welded %d vertices to %d\n", int(vertexCount), int(newVertexCount));
+
+    // Reorder triangles for the post-transform cache, then vertices in order of first use
+    meshopt_optimizeVertexCache(newIndices.data(), newIndices.data(), indexCount, newVertexCount);
+
+    std::vector<unsigned int> fetchRemap(newVertexCount);
+    meshopt_optimizeVertexFetchRemap(fetchRemap.data(), newIndices.data(), indexCount, newVertexCount);
+    meshopt_remapIndexBuffer(newIndices.data(), newIndices.data(), indexCount, fetchRemap.data());
+
+    for (unsigned int& newIndex : remap)
+    {
+      if (newIndex != ~0u)
+      {
+        newIndex = fetchRemap[newIndex];
+      }
+    }
+
+    indices.assign(newIndices.begin(), newIndices.end());
+  }
+
+  bool simplifyTriangleMesh(VtIntArray& indices,
+                            const VtVec3fArray& positions,
+                            float targetRatio,
+                            std::vector<unsigned int>& remap,
+                            size_t& newVertexCount)
+  {
+    TF_VERIFY((indices.size() % 3) == 0);
+
+    size_t indexCount = indices.size();
+    size_t vertexCount = positions.size();
+    const float* positionData = (const float*) positions.cdata();
+
+    size_t targetIndexCount = size_t(float(indexCount / 3) * targetRatio) * 3;
+
+    std::vector<unsigned int> srcIndices(indices.begin(), indices.end());
+    std::vector<unsigned int> newIndices(indexCount);
+
+    // Simplify position-only indices. Proxies need not preserve attribute seams, and de-indexed
+    // meshes (e.g. with generated flat normals) would not share any vertices otherwise.
+    std::vector<unsigned int> shadowIndices(indexCount);
+    meshopt_generateShadowIndexBuffer(shadowIndices.data(), srcIndices.data(), indexCount, positionData,
+                                      vertexCount, sizeof(GfVec3f), sizeof(GfVec3f));
+
+    float resultError = 0.0f;
+    size_t newIndexCount = meshopt_simplify(newIndices.data(), shadowIndices.data(), indexCount, positionData, vertexCount,
+                                            sizeof(GfVec3f), targetIndexCount, detail::SIMPLIFICATION_TARGET_ERROR,
+                                            0, &resultError);
+
+    // The error bound can prevent reaching the target. Sloppy simplification ignores topology,
+    // and as it degrades quality considerably, it is only used if the result is well above target.
+    size_t maxTriangleCount = size_t(float(targetIndexCount / 3) * (1.0f + detail::SIMPLIFICATION_TARGET_TOLERANCE));
+
+    if ((newIndexCount / 3) > maxTriangleCount)
+    {
+      TF_DEBUG(GUC).Msg("simplification stopped at %d of %d target triangles (error %f); simplifying sloppily\n",
+        int(newIndexCount / 3), int(targetIndexCount / 3), resultError);
+
+      newIndexCount = meshopt_simplifySloppy(newIndices.data(), shadowIndices.data(), indexCount, positionData,
+                                             vertexCount, sizeof(GfVec3f), targetIndexCount, FLT_MAX, &resultError);
+
+      TF_DEBUG(GUC).Msg("sloppily simplified mesh from %d to %d triangles (error %f)\n",
+        int(indexCount / 3), int(newIndexCount / 3), resultError);
+    }
+    else
+    {
+      TF_DEBUG(GUC).Msg("simplified mesh from %d to %d triangles (error %f)\n",
+        int(indexCount / 3), int(newIndexCount / 3), resultError);
+    }
+
+    if (newIndexCount == 0)
+    {
+      return false;
+    }
+    newIndices.resize(newIndexCount);
+
+    remap.resize(vertexCount);
+    newVertexCount = meshopt_optimizeVertexFetchRemap(remap.data(), newIndices.data(), newIndexCount, vertexCount);
+    meshopt_remapIndexBuffer(newIndices.data(), newIndices.data(), newIndexCount, remap.data());
+
+    indices.assign(newIndices.begin(), newIndices.end());
+    return true;
   }
 }
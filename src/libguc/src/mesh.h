@@ -19,6 +19,9 @@
 #include <cgltf.h>
 
 #include <pxr/base/vt/array.h>
+#include <pxr/base/vt/types.h>
+
+#include <vector>
 
 using namespace PXR_NS;
 
@@ -33,10 +36,93 @@ namespace guc
                          const VtVec3fArray& positions,
                          VtVec3fArray& normals);
 
+  // Face-varying variant: normals are shared among faces and indexed per face corner
+  void createFlatNormals(const VtIntArray& indices,
+                         const VtVec3fArray& positions,
+                         VtVec3fArray& normals,
+                         VtIntArray& normalIndices);
+
+  // The following functions use SIMD instructions (SSE2, AVX2 or NEON) which are
+  // selected at runtime, with a scalar fallback.
+
+  // Computes (x, 1 - y)
+  void flipTexCoordsY(VtVec2fArray& texCoords);
+
+  void multiplyComponents(VtVec3fArray& values, const GfVec3f& factor);
+
+  void multiplyValues(VtFloatArray& values, float factor);
+
+  // Splits four-component vectors into their xyz and (optional) w parts
+  void splitVec4Array(const VtVec4fArray& src, VtVec3fArray& xyz, VtFloatArray* w);
+
+  // Generates MikkTSpace tangents per face corner. Normals are accessed through their own
+  // indices, which may be face-varying. Large meshes are split into chunks, each extended by
+  // the faces around its vertices, which are processed in parallel if multithreaded is set.
   bool createTangents(const VtIntArray& indices,
                       const VtVec3fArray& positions,
                       const VtVec3fArray& normals,
+                      const VtIntArray& normalIndices,
                       const VtVec2fArray& texcoords,
                       VtFloatArray& signs,
-                      VtVec3fArray& tangents);
+                      VtVec3fArray& tangents,
+                      bool multithreaded);
+
+  // Re-indexes per-corner tangent frames, splitting vertices only where the frames differ.
+  // Afterwards, tangents and signs are per vertex, and sourceVertices maps each new vertex
+  // to the original vertex from which the other vertex attributes are to be copied.
+  void weldTangentFrames(VtIntArray& indices,
+                         VtVec3fArray& tangents,
+                         VtFloatArray& signs,
+                         VtIntArray& sourceVertices);
+
+  // A per-vertex attribute array, viewed as raw bytes
+  struct VertexStream
+  {
+    const void* data;
+    size_t elementSize;
+  };
+
+  // Finds the elements that are identical in all streams. The remap table maps each
+  // element to the index of its unique value; the number of unique values is returned.
+  size_t generateUniqueElementRemap(const std::vector<VertexStream>& streams,
+                                    size_t elementCount,
+                                    std::vector<unsigned int>& remap);
+
+  // Removes degenerate and zero-area triangles, welds vertices that are identical in
+  // all streams, and reorders triangles and vertices for GPU vertex cache and fetch
+  // efficiency. The resulting remap table maps old to new vertex indices (~0u for
+  // removed vertices) and must be applied to all vertex arrays using remapVertexArray.
+  void optimizeTriangleMesh(VtIntArray& indices,
+                            const VtVec3fArray& positions,
+                            const std::vector<VertexStream>& streams,
+                            std::vector<unsigned int>& remap,
+                            size_t& newVertexCount);
+
+  // Reduces the triangle count to approximately the given ratio. Topology is preserved
+  // if possible; otherwise, the mesh is simplified sloppily. Unused vertices are removed
+  // using the remap table, as with optimizeTriangleMesh. Returns false if no triangles remain.
+  bool simplifyTriangleMesh(VtIntArray& indices,
+                            const VtVec3fArray& positions,
+                            float targetRatio,
+                            std::vector<unsigned int>& remap,
+                            size_t& newVertexCount);
+
+  template<typename T>
+  void remapVertexArray(VtArray<T>& arr, const std::vector<unsigned int>& remap, size_t newVertexCount)
+  {
+    const T* srcData = arr.cdata();
+
+    VtArray<T> newArr(newVertexCount);
+    T* dstData = newArr.data();
+
+    for (size_t i = 0; i < remap.size(); i++)
+    {
+      if (remap[i] != ~0u)
+      {
+        dstData[remap[i]] = srcData[i];
+      }
+    }
+
+    arr = std::move(newArr);
+  }
 }
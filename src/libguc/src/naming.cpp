@@ -16,7 +16,7 @@
 
 #include "naming.h"
 
-#include <pxr/usd/usd/object.h>
+#include <pxr/usd/usd/prim.h>
 #include <pxr/usd/usdUtils/pipeline.h>
 #include <MaterialXFormat/Util.h>
 
@@ -97,6 +97,11 @@ namespace guc
     return name + std::to_string(index);
   }
 
+  std::string makePrimitiveSubsetName(int primitiveIndex)
+  {
+    return "primitive_" + std::to_string(primitiveIndex);
+  }
+
   const static std::unordered_set<std::string> MTLX_TYPE_NAME_SET = {
     /* Basic data types */
     "integer", "boolean", "float", "color3", "color4", "vector2", "vector3",
@@ -107,10 +112,79 @@ namespace guc
     "color", "shader", "material"
   };
 
+  std::string UniqueNameRegistry::makeUniqueName(const std::string& baseName,
+                                                 const std::string& delimiter,
+                                                 const std::string& extension)
+  {
+    std::string name = baseName + extension;
+    if (reserveName(name))
+    {
+      return name;
+    }
+
+    // Continue where the previous request with the same parameters stopped
+    std::string key = baseName + '\0' + delimiter + '\0' + extension;
+    int& nextSuffix = m_nextSuffixes.try_emplace(key, 1).first->second;
+
+    std::string prefix = baseName + delimiter;
+    do
+    {
+      name = prefix + std::to_string(nextSuffix) + extension;
+      nextSuffix++;
+    }
+    while (!reserveName(name));
+
+    return name;
+  }
+
+  bool UniqueNameRegistry::reserveName(const std::string& name)
+  {
+    return m_names.insert(name).second;
+  }
+
+  UniquePathRegistry::UniquePathRegistry(UsdStageRefPtr stage)
+    : m_stage(stage)
+  {
+  }
+
+  SdfPath UniquePathRegistry::makeUniqueSubpath(const SdfPath& root,
+                                                const std::string& baseName,
+                                                const std::string& delimiter)
+  {
+    auto [iter, isNewRegistry] = m_registries.try_emplace(root);
+    UniqueNameRegistry& registry = iter->second;
+
+    if (isNewRegistry)
+    {
+      UsdPrim prim = m_stage->GetPrimAtPath(root);
+      if (prim)
+      {
+        for (const TfToken& childName : prim.GetAllChildrenNames())
+        {
+          registry.reserveName(childName.GetString());
+        }
+      }
+    }
+
+    std::string name = registry.makeUniqueName(TfMakeValidIdentifier(baseName), delimiter);
+
+    return root.AppendElementString(name);
+  }
+
+  UniqueNameRegistry makeMaterialNameRegistry()
+  {
+    UniqueNameRegistry registry;
+    for (const std::string& typeName : MTLX_TYPE_NAME_SET)
+    {
+      registry.reserveName(typeName);
+    }
+    return registry;
+  }
+
   const char* DEFAULT_MATERIAL_NAME = "mat";
 
   std::string makeUniqueMaterialName(std::string baseName,
-                                     const std::unordered_set<std::string>& existingNames)
+                                     UniqueNameRegistry& registry)
   {
     if (baseName.empty())
     {
@@ -128,17 +202,15 @@ namespace guc
       }
     }
 
-    std::string name = baseName;
+    return registry.makeUniqueName(baseName);
+  }
 
-    int i = 1;
-    while (existingNames.find(name) != existingNames.end() ||
-           MTLX_TYPE_NAME_SET.find(name) != MTLX_TYPE_NAME_SET.end())
-    {
-      name = baseName + "_" + std::to_string(i);
-      i++;
-    }
+  bool SharedPathRegistry::reservePath(const fs::path& path)
+  {
+    std::string normalizedPath = fs::absolute(path).lexically_normal().string();
 
-    return name;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_paths.insert(normalizedPath).second;
   }
 
   const char* DEFAULT_IMAGE_FILENAME = "img";
@@ -146,7 +218,7 @@ namespace guc
   std::string makeUniqueImageFileName(const char* nameHint,
                                       const std::string& fileName,
                                       const std::string& fileExt,
-                                      const std::unordered_set<std::string>& existingNames)
+                                      UniqueNameRegistry& registry)
   {
     std::string baseName = fileName;
 
@@ -162,35 +234,7 @@ namespace guc
       baseName = DEFAULT_IMAGE_FILENAME;
     }
 
-    auto finalName = baseName + fileExt;
-
-    int i = 1;
-    while (existingNames.find(finalName) != existingNames.end())
-    {
-      finalName = baseName + "_" + std::to_string(i) + fileExt;
-      i++;
-    }
-
-    return finalName;
-  }
-
-  SdfPath makeUniqueStageSubpath(UsdStageRefPtr stage,
-                                 const SdfPath& root,
-                                 const std::string& baseName,
-                                 const std::string& delimiter)
-  {
-    SdfPath finalPath = root.AppendElementString(TfMakeValidIdentifier(baseName));
-
-    std::string basePath = finalPath.GetAsString();
-    // FIXME: evaluate performance impact of GetObjectAtPath compared to simple hashmap
-    for (int i = 1; stage->GetObjectAtPath(finalPath); i++)
-    {
-      auto newPathStr = basePath + delimiter + std::to_string(i);
-      TF_VERIFY(SdfPath::IsValidPathString(newPathStr));
-      finalPath = SdfPath(newPathStr);
-    }
-
-    return finalPath;
+    return registry.makeUniqueName(baseName, "_", fileExt);
   }
 
   SdfPath makeMtlxMaterialPath(const std::string& materialName)
@@ -18,6 +18,10 @@
 
 #include <pxr/usd/usd/stage.h>
 
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace PXR_NS;
@@ -45,19 +49,69 @@ namespace guc
   std::string makeStSetName(int index);
   std::string makeColorSetName(int index);
   std::string makeOpacitySetName(int index);
+  std::string makePrimitiveSubsetName(int primitiveIndex);
+
+  // Hands out names that are unique within a namespace. Names are formed by appending a
+  // delimiter and an increasing number to a base name. The next number to try is stored
+  // per base name, so that repeated requests for the same base name are amortized O(1).
+  class UniqueNameRegistry
+  {
+  public:
+    // Returns baseName + extension if not taken yet, and otherwise
+    // baseName + delimiter + i + extension with the smallest free i >= 1.
+    std::string makeUniqueName(const std::string& baseName,
+                               const std::string& delimiter = "_",
+                               const std::string& extension = "");
+
+    // Marks a name as taken. Returns false if it already was.
+    bool reserveName(const std::string& name);
+
+  private:
+    std::unordered_set<std::string> m_names;
+    std::unordered_map<std::string, int> m_nextSuffixes;
+  };
+
+  // Hands out unique prim paths, using one name registry per parent path. A registry is
+  // seeded with the children that exist on the stage when its parent is first used;
+  // afterwards, the stage is not queried anymore. All children of that parent must
+  // therefore be named through this class.
+  class UniquePathRegistry
+  {
+  public:
+    explicit UniquePathRegistry(UsdStageRefPtr stage);
+
+    SdfPath makeUniqueSubpath(const SdfPath& root,
+                              const std::string& baseName,
+                              const std::string& delimiter = "_");
+
+  private:
+    UsdStageRefPtr m_stage;
+    std::unordered_map<SdfPath, UniqueNameRegistry, SdfPath::Hash> m_registries;
+  };
+
+  // Reserves file paths across concurrent conversions, for instance of a batch
+  // which writes multiple assets to the same directory.
+  class SharedPathRegistry
+  {
+  public:
+    // Returns false if the path was already reserved
+    bool reservePath(const std::filesystem::path& path);
+
+  private:
+    std::mutex m_mutex;
+    std::unordered_set<std::string> m_paths;
+  };
+
+  // Reserves names that must not be used for materials
+  UniqueNameRegistry makeMaterialNameRegistry();
 
   std::string makeUniqueMaterialName(std::string baseName,
-                                     const std::unordered_set<std::string>& existingNames);
+                                     UniqueNameRegistry& registry);
 
   std::string makeUniqueImageFileName(const char* nameHint,
                                       const std::string& fileName,
                                       const std::string& fileExt,
-                                      const std::unordered_set<std::string>& existingNames);
-
-  SdfPath makeUniqueStageSubpath(UsdStageRefPtr stage,
-                                 const SdfPath& root,
-                                 const std::string& baseName,
-                                 const std::string& delimiter = "_");
+                                      UniqueNameRegistry& registry);
 
   SdfPath makeMtlxMaterialPath(const std::string& materialName);
 
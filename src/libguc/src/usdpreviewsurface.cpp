@@ -132,9 +132,11 @@ namespace detail
 namespace guc
 {
   UsdPreviewSurfaceMaterialConverter::UsdPreviewSurfaceMaterialConverter(UsdStageRefPtr stage,
-                                                                         const ImageMetadataMap& imageMetadataMap)
+                                                                         const ImageMetadataMap& imageMetadataMap,
+                                                                         UniquePathRegistry& pathRegistry)
     : m_stage(stage)
     , m_imageMetadataMap(imageMetadataMap)
+    , m_pathRegistry(pathRegistry)
   {
   }
 
@@ -145,7 +147,7 @@ namespace guc
 
     // FIXME: the first node will be called 'node' while MaterialX's first node is 'node1'
     const char* nodeNameNumberDelimiter = ""; // mimic MaterialX nodename generation with no delimiter between "node" and number
-    auto shaderPath = makeUniqueStageSubpath(m_stage, path, "node", nodeNameNumberDelimiter);
+    auto shaderPath = m_pathRegistry.makeUniqueSubpath(path, "node", nodeNameNumberDelimiter);
     auto shader = UsdShadeShader::Define(m_stage, shaderPath);
     shader.CreateIdAttr(VtValue(_tokens->UsdPreviewSurface));
     auto shaderOutput = shader.CreateOutput(UsdShadeTokens->surface, SdfValueTypeNames->Token);
@@ -379,7 +381,7 @@ namespace guc
                                                                    int stIndex,
                                                                    UsdShadeInput& textureStInput)
   {
-    auto nodePath = makeUniqueStageSubpath(m_stage, basePath, "node", "");
+    auto nodePath = m_pathRegistry.makeUniqueSubpath(basePath, "node", "");
 
     UsdShadeShader node = UsdShadeShader::Define(m_stage, nodePath);
     node.CreateIdAttr(VtValue(_tokens->UsdTransform2d));
@@ -419,7 +421,7 @@ namespace guc
       return false;
     }
 
-    auto nodePath = makeUniqueStageSubpath(m_stage, basePath, "node", "");
+    auto nodePath = m_pathRegistry.makeUniqueSubpath(basePath, "node", "");
     node = UsdShadeShader::Define(m_stage, nodePath);
     node.CreateIdAttr(VtValue(_tokens->UsdUVTexture));
 
@@ -478,7 +480,7 @@ namespace guc
                                                              const SdfPath& nodeBasePath,
                                                              int stIndex)
   {
-    auto nodePath = makeUniqueStageSubpath(m_stage, nodeBasePath, "node", "");
+    auto nodePath = m_pathRegistry.makeUniqueSubpath(nodeBasePath, "node", "");
     auto node = UsdShadeShader::Define(m_stage, nodePath);
     node.CreateIdAttr(VtValue(_tokens->UsdPrimvarReader_float2));
 
@@ -22,6 +22,7 @@
 #include <pxr/usd/usdShade/shader.h>
 
 #include "image.h"
+#include "naming.h"
 
 using namespace PXR_NS;
 
@@ -31,13 +32,15 @@ namespace guc
   {
   public:
     UsdPreviewSurfaceMaterialConverter(UsdStageRefPtr stage,
-                                       const ImageMetadataMap& imageMetadataMap);
+                                       const ImageMetadataMap& imageMetadataMap,
+                                       UniquePathRegistry& pathRegistry);
 
     void convert(const cgltf_material* material, const SdfPath& path);
 
   private:
     UsdStageRefPtr m_stage;
     const ImageMetadataMap& m_imageMetadataMap;
+    UniquePathRegistry& m_pathRegistry;
 
   private:
     void setNormalTextureInput(const SdfPath& basePath,
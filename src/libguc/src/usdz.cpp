@@ -0,0 +1,273 @@
+//
+// Copyright 2022 Pablo Delgado Krämer
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "usdz.h"
+
+#include <pxr/base/arch/fileSystem.h>
+#include <pxr/base/tf/diagnostic.h>
+
+#include <array>
+#include <limits>
+
+#include "debugCodes.h"
+
+using namespace PXR_NS;
+
+namespace detail
+{
+  constexpr uint32_t LOCAL_FILE_HEADER_SIGNATURE = 0x04034b50;
+  constexpr uint32_t CENTRAL_DIR_HEADER_SIGNATURE = 0x02014b50;
+  constexpr uint32_t END_OF_CENTRAL_DIR_SIGNATURE = 0x06054b50;
+  constexpr size_t LOCAL_FILE_HEADER_SIZE = 30;
+  constexpr size_t EXTRA_FIELD_HEADER_SIZE = 4;
+  constexpr uint16_t PADDING_EXTRA_FIELD_ID = 0x1986; // Same ID as UsdZipFileWriter
+  constexpr uint16_t ZIP_VERSION = 20;
+  constexpr uint16_t DOS_DATE_1980_01_01 = (1 << 5) | 1;
+  constexpr size_t USDZ_DATA_ALIGNMENT = 64;
+
+  std::array<uint32_t, 256> makeCrc32Table()
+  {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; i++)
+    {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++)
+      {
+        c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      }
+      table[i] = c;
+    }
+    return table;
+  }
+
+  uint32_t crc32(const void* data, size_t size)
+  {
+    static const std::array<uint32_t, 256> table = makeCrc32Table();
+
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+    {
+      c = table[(c ^ bytes[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+  }
+
+  // Zip headers are little-endian
+  void appendU16(std::vector<uint8_t>& buf, uint16_t value)
+  {
+    buf.push_back(uint8_t(value));
+    buf.push_back(uint8_t(value >> 8));
+  }
+
+  void appendU32(std::vector<uint8_t>& buf, uint32_t value)
+  {
+    appendU16(buf, uint16_t(value));
+    appendU16(buf, uint16_t(value >> 16));
+  }
+}
+
+namespace guc
+{
+  UsdzWriter::~UsdzWriter()
+  {
+    if (m_file)
+    {
+      fclose(m_file);
+    }
+  }
+
+  bool UsdzWriter::open(const char* filePath)
+  {
+    m_file = ArchOpenFile(filePath, "wb");
+    if (!m_file)
+    {
+      TF_RUNTIME_ERROR("unable to open %s for writing", filePath);
+      return false;
+    }
+
+    m_offset = 0;
+    m_entries.clear();
+    return true;
+  }
+
+  bool UsdzWriter::addFile(const std::string& pathInArchive, const void* data, size_t size)
+  {
+    if (!m_file)
+    {
+      return false;
+    }
+
+    if (size > std::numeric_limits<uint32_t>::max() ||
+        pathInArchive.size() > std::numeric_limits<uint16_t>::max())
+    {
+      TF_RUNTIME_ERROR("unable to add %s to USDZ archive: zip64 not supported", pathInArchive.c_str());
+      return false;
+    }
+
+    // Pad the extra field so that the file data starts at a 64-byte boundary
+    size_t dataOffset = m_offset + detail::LOCAL_FILE_HEADER_SIZE + pathInArchive.size();
+    size_t padding = (detail::USDZ_DATA_ALIGNMENT - (dataOffset % detail::USDZ_DATA_ALIGNMENT)) % detail::USDZ_DATA_ALIGNMENT;
+    if (padding > 0 && padding < detail::EXTRA_FIELD_HEADER_SIZE)
+    {
+      padding += detail::USDZ_DATA_ALIGNMENT;
+    }
+
+    if (m_offset + padding + size > std::numeric_limits<uint32_t>::max())
+    {
+      TF_RUNTIME_ERROR("unable to add %s to USDZ archive: zip64 not supported", pathInArchive.c_str());
+      return false;
+    }
+
+    Entry entry;
+    entry.path = pathInArchive;
+    entry.crc = detail::crc32(data, size);
+    entry.size = uint32_t(size);
+    entry.localHeaderOffset = uint32_t(m_offset);
+
+    std::vector<uint8_t> header;
+    header.reserve(detail::LOCAL_FILE_HEADER_SIZE + pathInArchive.size() + padding);
+    detail::appendU32(header, detail::LOCAL_FILE_HEADER_SIGNATURE);
+    detail::appendU16(header, detail::ZIP_VERSION); // version needed to extract
+    detail::appendU16(header, 0); // general purpose flags
+    detail::appendU16(header, 0); // compression method: stored
+    detail::appendU16(header, 0); // last modification time
+    detail::appendU16(header, detail::DOS_DATE_1980_01_01); // last modification date
+    detail::appendU32(header, entry.crc);
+    detail::appendU32(header, entry.size); // compressed size
+    detail::appendU32(header, entry.size); // uncompressed size
+    detail::appendU16(header, uint16_t(pathInArchive.size()));
+    detail::appendU16(header, uint16_t(padding));
+    header.insert(header.end(), pathInArchive.begin(), pathInArchive.end());
+
+    if (padding > 0)
+    {
+      detail::appendU16(header, detail::PADDING_EXTRA_FIELD_ID);
+      detail::appendU16(header, uint16_t(padding - detail::EXTRA_FIELD_HEADER_SIZE));
+      header.resize(header.size() + padding - detail::EXTRA_FIELD_HEADER_SIZE, 0);
+    }
+
+    TF_DEBUG(GUC).Msg("adding %s to USDZ archive\n", pathInArchive.c_str());
+    if (!write(header.data(), header.size()) || !write(data, size))
+    {
+      TF_RUNTIME_ERROR("unable to write %s to USDZ archive", pathInArchive.c_str());
+      return false;
+    }
+
+    m_entries.push_back(entry);
+    return true;
+  }
+
+  bool UsdzWriter::addFileFromPath(const std::string& pathInArchive, const char* srcFilePath)
+  {
+    FILE* file = ArchOpenFile(srcFilePath, "rb");
+    if (!file)
+    {
+      TF_RUNTIME_ERROR("unable to open %s", srcFilePath);
+      return false;
+    }
+
+    int64_t size = ArchGetFileLength(file);
+    bool result = false;
+
+    if (size == 0)
+    {
+      result = addFile(pathInArchive, nullptr, 0);
+    }
+    else if (size > 0)
+    {
+      ArchConstFileMapping mapping = ArchMapFileReadOnly(file);
+      if (mapping)
+      {
+        result = addFile(pathInArchive, mapping.get(), size_t(size));
+      }
+      else
+      {
+        TF_RUNTIME_ERROR("unable to map %s", srcFilePath);
+      }
+    }
+
+    fclose(file);
+    return result;
+  }
+
+  bool UsdzWriter::close()
+  {
+    if (!m_file)
+    {
+      return false;
+    }
+
+    uint64_t centralDirOffset = m_offset;
+
+    std::vector<uint8_t> centralDir;
+    for (const Entry& entry : m_entries)
+    {
+      detail::appendU32(centralDir, detail::CENTRAL_DIR_HEADER_SIGNATURE);
+      detail::appendU16(centralDir, detail::ZIP_VERSION); // version made by
+      detail::appendU16(centralDir, detail::ZIP_VERSION); // version needed to extract
+      detail::appendU16(centralDir, 0); // general purpose flags
+      detail::appendU16(centralDir, 0); // compression method: stored
+      detail::appendU16(centralDir, 0); // last modification time
+      detail::appendU16(centralDir, detail::DOS_DATE_1980_01_01); // last modification date
+      detail::appendU32(centralDir, entry.crc);
+      detail::appendU32(centralDir, entry.size); // compressed size
+      detail::appendU32(centralDir, entry.size); // uncompressed size
+      detail::appendU16(centralDir, uint16_t(entry.path.size()));
+      detail::appendU16(centralDir, 0); // extra field length
+      detail::appendU16(centralDir, 0); // file comment length
+      detail::appendU16(centralDir, 0); // disk number start
+      detail::appendU16(centralDir, 0); // internal file attributes
+      detail::appendU32(centralDir, 0); // external file attributes
+      detail::appendU32(centralDir, entry.localHeaderOffset);
+      centralDir.insert(centralDir.end(), entry.path.begin(), entry.path.end());
+    }
+
+    std::vector<uint8_t> endOfCentralDir;
+    detail::appendU32(endOfCentralDir, detail::END_OF_CENTRAL_DIR_SIGNATURE);
+    detail::appendU16(endOfCentralDir, 0); // number of this disk
+    detail::appendU16(endOfCentralDir, 0); // disk where central directory starts
+    detail::appendU16(endOfCentralDir, uint16_t(m_entries.size())); // entries on this disk
+    detail::appendU16(endOfCentralDir, uint16_t(m_entries.size())); // total entries
+    detail::appendU32(endOfCentralDir, uint32_t(centralDir.size()));
+    detail::appendU32(endOfCentralDir, uint32_t(centralDirOffset));
+    detail::appendU16(endOfCentralDir, 0); // comment length
+
+    bool result = m_entries.size() <= std::numeric_limits<uint16_t>::max() &&
+                  centralDirOffset + centralDir.size() <= std::numeric_limits<uint32_t>::max() &&
+                  write(centralDir.data(), centralDir.size()) &&
+                  write(endOfCentralDir.data(), endOfCentralDir.size());
+
+    result &= (fclose(m_file) == 0);
+    m_file = nullptr;
+
+    if (!result)
+    {
+      TF_RUNTIME_ERROR("unable to finalize USDZ archive");
+    }
+    return result;
+  }
+
+  bool UsdzWriter::write(const void* data, size_t size)
+  {
+    if (size > 0 && fwrite(data, 1, size, m_file) != size)
+    {
+      return false;
+    }
+    m_offset += size;
+    return true;
+  }
+}
@@ -0,0 +1,66 @@
+//
+// Copyright 2022 Pablo Delgado Krämer
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+namespace guc
+{
+  // Streams files into an uncompressed zip archive with 64-byte aligned file data,
+  // as required by the USDZ specification. Unlike UsdZipFileWriter, files can be
+  // added from memory. Zip64 is not supported.
+  class UsdzWriter
+  {
+  public:
+    UsdzWriter() = default;
+    ~UsdzWriter();
+
+    UsdzWriter(const UsdzWriter&) = delete;
+    UsdzWriter& operator=(const UsdzWriter&) = delete;
+
+  public:
+    bool open(const char* filePath);
+
+    bool addFile(const std::string& pathInArchive, const void* data, size_t size);
+
+    bool addFileFromPath(const std::string& pathInArchive, const char* srcFilePath);
+
+    // Writes the central directory and closes the file
+    bool close();
+
+  private:
+    struct Entry
+    {
+      std::string path;
+      uint32_t crc;
+      uint32_t size;
+      uint32_t localHeaderOffset;
+    };
+
+  private:
+    bool write(const void* data, size_t size);
+
+  private:
+    FILE* m_file = nullptr;
+    uint64_t m_offset = 0;
+    std::vector<Entry> m_entries;
+  };
+}